@@ -74,6 +74,10 @@ static inline int ahci_port_is_active(const hba_port_t *const port)
 /** Do minimal error recovery. */
 int ahci_error_recovery(ahci_dev_t *const dev, const u32 intr_status)
 {
+	/* A device that failed a queued command won't accept new ones
+	   before it's reset (we don't read the NCQ error log). */
+	const u32 queued = dev->port->sata_active;
+
 	/* Command engine has to be restarted.
 	   We don't call ahci_cmdengine_stop() here as it also checks
 	   HBA_PxCMD_FR which won't clear on fatal errors. */
@@ -85,7 +89,7 @@ int ahci_error_recovery(ahci_dev_t *const dev, const u32 intr_status)
 	/* Perform COMRESET if appropriate. */
 	const u32 tfd = dev->port->taskfile_data;
 	if ((tfd & (HBA_PxTFD_BSY | HBA_PxTFD_DRQ)) |
-			(intr_status & HBA_PxIS_PCS)) {
+			(intr_status & HBA_PxIS_PCS) | queued) {
 		const u32 sctl = dev->port->sata_control & ~HBA_PxSCTL_DET_MASK;
 		dev->port->sata_control = sctl | HBA_PxSCTL_DET_COMRESET;
 		mdelay(1);
@@ -107,16 +111,16 @@ static int ahci_dev_init(hba_ctrl_t *const ctrl,
 
 	const int ncs = HBA_CAPS_DECODE_NCS(ctrl->caps);
 
-	/* Allocate command list, one command table and received FIS. */
+	/* Allocate command list, a command table per slot and received FIS. */
 	cmd_t *const cmdlist = memalign(1024, ncs * sizeof(cmd_t));
-	cmdtable_t *const cmdtable = memalign(128, sizeof(cmdtable_t));
+	cmdtable_t *const cmdtable = memalign(128, ncs * sizeof(cmdtable_t));
 	rcvd_fis_t *const rcvd_fis = memalign(256, sizeof(rcvd_fis_t));
 	/* Allocate our device structure. */
 	ahci_dev_t *const dev = calloc(1, sizeof(ahci_dev_t));
 	if (!cmdlist || !cmdtable || !rcvd_fis || !dev)
 		goto _cleanup_ret;
 	memset((void *)cmdlist, '\0', ncs * sizeof(cmd_t));
-	memset((void *)cmdtable, '\0', sizeof(*cmdtable));
+	memset((void *)cmdtable, '\0', ncs * sizeof(*cmdtable));
 	memset((void *)rcvd_fis, '\0', sizeof(*rcvd_fis));
 
 	/* Set command list base and received FIS base. */
@@ -133,6 +137,7 @@ static int ahci_dev_init(hba_ctrl_t *const ctrl,
 	dev->port = port;
 	dev->cmdlist = cmdlist;
 	dev->cmdtable = cmdtable;
+	dev->cmdtables = cmdtable;
 	dev->rcvd_fis = rcvd_fis;
 
 	/*
@@ -155,6 +160,13 @@ static int ahci_dev_init(hba_ctrl_t *const ctrl,
 #if IS_ENABLED(CONFIG_LP_STORAGE_ATA)
 		dev->ata_dev.identify = ahci_identify_device;
 		dev->ata_dev.read_sectors = ahci_ata_read_sectors;
+		dev->ata_dev.submit_read_sectors = ahci_ata_submit_read;
+		dev->ata_dev.complete_read = ahci_ata_complete_read;
+		if (IS_ENABLED(CONFIG_LP_STORAGE_AHCI_NCQ) &&
+				(ctrl->caps & HBA_CAPS_SNCQ))
+			dev->ata_dev.queue_depth = ncs;
+		else
+			dev->ata_dev.queue_depth = 1;
 		return ata_attach_device(&dev->ata_dev, PORT_TYPE_SATA);
 #endif
 		break;
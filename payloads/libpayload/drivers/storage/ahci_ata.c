@@ -39,62 +39,175 @@
 #include "ahci_private.h"
 
 
-ssize_t ahci_ata_read_sectors(ata_dev_t *const ata_dev,
-				     const lba_t start, size_t count,
-				     u8 *const buf)
+/** Check the range of a read, count may be cut to the command's limit. */
+static int ahci_ata_check_range(ata_dev_t *const ata_dev,
+				const lba_t start, size_t *const count)
 {
-	ahci_dev_t *const dev = (ahci_dev_t *)ata_dev;
-
-	if (count == 0)
-		return 0;
-
 	if (ata_dev->read_cmd == ATA_READ_DMA) {
 		if (start >= (1 << 28)) {
 		       printf("ahci: Sector is not 28-bit addressable.\n");
 		       return -1;
-		} else if (count > 256) {
-		       printf("ahci: Sector count too high (max. 256).\n");
-		       count = 256;
 		}
+		*count = MIN(*count, 256);
+	} else if (ata_dev->read_cmd == ATA_READ_DMA_EXT ||
+		   ata_dev->read_cmd == ATA_READ_FPDMA_QUEUED) {
 #if IS_ENABLED(CONFIG_LP_STORAGE_64BIT_LBA)
-	} else if (ata_dev->read_cmd == ATA_READ_DMA_EXT) {
 		if (start >= (1ULL << 48)) {
 			printf("ahci: Sector is not 48-bit addressable.\n");
 			return -1;
-		} else if (count > (64 * 1024)) {
-		       printf("ahci: Sector count too high (max. 65536).\n");
-		       count = 64 * 1024;
 		}
 #endif
+		*count = MIN(*count, 64 * 1024);
 	} else {
 		printf("ahci: Unsupported ATA read command (0x%x).\n",
 			ata_dev->read_cmd);
 		return -1;
 	}
+	return 0;
+}
+
+static void ahci_ata_setup_fis(ata_dev_t *const ata_dev,
+			       volatile u8 *const fis,
+			       const lba_t start, const size_t sectors,
+			       const int tag)
+{
+	fis[ 0] = FIS_HOST_TO_DEVICE;
+	fis[ 1] = FIS_H2D_CMD;
+	fis[ 2] = ata_dev->read_cmd;
+	fis[ 4] = (start >>  0) & 0xff;
+	fis[ 5] = (start >>  8) & 0xff;
+	fis[ 6] = (start >> 16) & 0xff;
+	fis[ 7] = FIS_H2D_DEV_LBA;
+	fis[ 8] = (start >> 24) & 0xff;
+#if IS_ENABLED(CONFIG_LP_STORAGE_64BIT_LBA)
+	if (ata_dev->read_cmd != ATA_READ_DMA) {
+		fis[ 9] = (start >> 32) & 0xff;
+		fis[10] = (start >> 40) & 0xff;
+	}
+#endif
+	if (ata_dev->read_cmd == ATA_READ_FPDMA_QUEUED) {
+		/* Queued commands carry the count in the feature field
+		   and the tag in the count field. */
+		fis[ 3] = (sectors >>  0) & 0xff;
+		fis[11] = (sectors >>  8) & 0xff;
+		fis[12] = FIS_H2D_NCQ_TAG(tag);
+	} else {
+		fis[12] = (sectors >>  0) & 0xff;
+		fis[13] = (sectors >>  8) & 0xff;
+	}
+}
+
+/**
+ * Start reading up to count sectors into buf without waiting for it.
+ *
+ * Devices that support NCQ can have as many reads in flight as they
+ * have command slots, others only one. The PRDT is built over buf
+ * directly, so buf has to have an even address.
+ *
+ * @return Tag to pass to ahci_ata_complete_read() or -1 on error.
+ */
+int ahci_ata_submit_read(ata_dev_t *const ata_dev,
+			 const lba_t start, size_t count,
+			 u8 *const buf)
+{
+	ahci_dev_t *const dev = (ahci_dev_t *)ata_dev;
+
+	if (count == 0 || ((uintptr_t)buf & 1))
+		return -1;
+	if (ahci_ata_check_range(ata_dev, start, &count))
+		return -1;
+
+	const int slot = ahci_cmdslot_alloc(dev, ata_dev->queue_depth);
+	if (slot < 0)
+		return -1;
 
 	const size_t bytes = count << ata_dev->sector_size_shift;
-	const size_t bytes_feasible = ahci_cmdslot_prepare(dev, buf, bytes, 0);
+	const size_t bytes_feasible = ahci_cmdslot_setup(dev, slot, buf, bytes);
 	const size_t sectors = bytes_feasible >> ata_dev->sector_size_shift;
 
-	dev->cmdtable->fis[ 0] = FIS_HOST_TO_DEVICE;
-	dev->cmdtable->fis[ 1] = FIS_H2D_CMD;
-	dev->cmdtable->fis[ 2] = ata_dev->read_cmd;
-	dev->cmdtable->fis[ 4] = (start >>  0) & 0xff;
-	dev->cmdtable->fis[ 5] = (start >>  8) & 0xff;
-	dev->cmdtable->fis[ 6] = (start >> 16) & 0xff;
-	dev->cmdtable->fis[ 7] = FIS_H2D_DEV_LBA;
-	dev->cmdtable->fis[ 8] = (start >> 24) & 0xff;
-#if IS_ENABLED(CONFIG_LP_STORAGE_64BIT_LBA)
-	if (ata_dev->read_cmd == ATA_READ_DMA_EXT) {
-		dev->cmdtable->fis[ 9] = (start >> 32) & 0xff;
-		dev->cmdtable->fis[10] = (start >> 40) & 0xff;
+	ahci_ata_setup_fis(ata_dev, dev->cmdtables[slot].fis,
+			   start, sectors, slot);
+
+	if (ahci_cmdslot_issue(dev, slot,
+			ata_dev->read_cmd == ATA_READ_FPDMA_QUEUED) < 0)
+		return -1;
+	return slot;
+}
+
+/**
+ * Wait for a read started by ahci_ata_submit_read().
+ *
+ * @return Number of sectors read or -1 on error.
+ */
+ssize_t ahci_ata_complete_read(ata_dev_t *const ata_dev, const int tag)
+{
+	const ssize_t bytes = ahci_cmdslot_complete((ahci_dev_t *)ata_dev, tag);
+
+	if (bytes < 0)
+		return -1;
+	return bytes >> ata_dev->sector_size_shift;
+}
+
+/** Read sectors, spread over all usable command slots. */
+static ssize_t ahci_ata_read_batched(ata_dev_t *const ata_dev,
+				     lba_t start, size_t count, u8 *buf)
+{
+	ahci_dev_t *const dev = (ahci_dev_t *)ata_dev;
+	ssize_t read = 0;
+	int failed = 0;
+
+	while (count > 0 && !failed) {
+		int tags[32], issued = 0, i;
+
+		/* Fill all free slots... */
+		while (count > 0) {
+			const int tag =
+				ahci_ata_submit_read(ata_dev, start, count, buf);
+			if (tag < 0)
+				break;
+			const size_t sectors = dev->slot_bytes[tag]
+				>> ata_dev->sector_size_shift;
+			tags[issued++] = tag;
+			start += sectors;
+			count -= sectors;
+			buf += sectors << ata_dev->sector_size_shift;
+		}
+		if (issued == 0)
+			return read ? read : -1;
+
+		/* ...and collect them in order. */
+		for (i = 0; i < issued; ++i) {
+			const ssize_t sectors =
+				ahci_ata_complete_read(ata_dev, tags[i]);
+			if (sectors < 0)
+				failed = 1;
+			else if (!failed)
+				read += sectors;
+		}
 	}
-#endif
-	dev->cmdtable->fis[12] = (sectors >>  0) & 0xff;
-	dev->cmdtable->fis[13] = (sectors >>  8) & 0xff;
 
-	if (ahci_cmdslot_exec(dev) < 0)
+	return (failed && !read) ? -1 : read;
+}
+
+ssize_t ahci_ata_read_sectors(ata_dev_t *const ata_dev,
+				     const lba_t start, size_t count,
+				     u8 *const buf)
+{
+	if (count == 0)
+		return 0;
+
+	if (!((uintptr_t)buf & 1))
+		return ahci_ata_read_batched(ata_dev, start, count, buf);
+
+	/* Odd buffers can't be described by a PRD, bounce them. */
+	printf("ahci: Odd buffer pointer (%p).\n", buf);
+	u8 *const bounce = malloc(count << ata_dev->sector_size_shift);
+	if (!bounce)
 		return -1;
-	else
-		return dev->cmdlist->prd_bytes >> ata_dev->sector_size_shift;
+	const ssize_t read =
+		ahci_ata_read_batched(ata_dev, start, count, bounce);
+	if (read > 0)
+		memcpy(buf, bounce, read << ata_dev->sector_size_shift);
+	free(bounce);
+	return read;
 }
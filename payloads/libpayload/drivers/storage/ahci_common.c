@@ -158,6 +158,11 @@ ssize_t ahci_cmdslot_exec(ahci_dev_t *const dev)
 {
 	const int slotnum = 0; /* We always use the first slot. */
 
+	if (dev->slots_busy) {
+		printf("ahci: Queued commands still outstanding.\n");
+		return -1;
+	}
+
 	if (!(dev->port->cmd_stat & HBA_PxCMD_CR))
 		return -1;
 
@@ -186,14 +191,31 @@ ssize_t ahci_cmdslot_exec(ahci_dev_t *const dev)
 	}
 }
 
+/** Describe buf in the PRDT of a command table, buf_len has to fit. */
+static void ahci_prdt_fill(cmd_t *const cmd, cmdtable_t *const cmdtable,
+			   u8 *buf, size_t buf_len)
+{
+	const size_t prdt_len = ((buf_len - 1) >> BYTES_PER_PRD_SHIFT) + 1;
+	int i;
+
+	cmd->prdt_length = prdt_len;
+	for (i = 0; i < prdt_len; ++i) {
+		const size_t bytes =
+			(buf_len < BYTES_PER_PRD)
+			? buf_len : BYTES_PER_PRD;
+		cmdtable->prdt[i].data_base = virt_to_phys(buf);
+		cmdtable->prdt[i].flags = PRD_TABLE_BYTES(bytes);
+		buf_len -= bytes;
+		buf += bytes;
+	}
+}
+
 size_t ahci_cmdslot_prepare(ahci_dev_t *const dev,
 				   u8 *const user_buf, size_t buf_len,
 				   const int out)
 {
 	const int slotnum = 0; /* We always use the first slot. */
 
-	size_t read_count = 0;
-
 	memset((void *)&dev->cmdlist[slotnum],
 			'\0', sizeof(dev->cmdlist[slotnum]));
 	memset((void *)dev->cmdtable,
@@ -202,35 +224,132 @@ size_t ahci_cmdslot_prepare(ahci_dev_t *const dev,
 	dev->cmdlist[slotnum].cmdtable_base = virt_to_phys(dev->cmdtable);
 
 	if (buf_len > 0) {
-		size_t prdt_len;
-		u8 *buf;
-		int i;
-
-		prdt_len = ((buf_len - 1) >> BYTES_PER_PRD_SHIFT) + 1;
-		const size_t max_prdt_len = ARRAY_SIZE(dev->cmdtable->prdt);
-		if (prdt_len > max_prdt_len) {
-			prdt_len = max_prdt_len;
-			buf_len = prdt_len << BYTES_PER_PRD_SHIFT;
-		}
-
-		dev->cmdlist[slotnum].prdt_length = prdt_len;
-		read_count = buf_len;
+		buf_len = MIN(buf_len, BYTES_PER_CMD);
 
-		buf = ahci_prdbuf_init(dev, user_buf, buf_len, out);
+		u8 *const buf = ahci_prdbuf_init(dev, user_buf, buf_len, out);
 		if (!buf)
 			return 0;
-		for (i = 0; i < prdt_len; ++i) {
-			const size_t bytes =
-				(buf_len < BYTES_PER_PRD)
-				? buf_len : BYTES_PER_PRD;
-			dev->cmdtable->prdt[i].data_base = virt_to_phys(buf);
-			dev->cmdtable->prdt[i].flags = PRD_TABLE_BYTES(bytes);
-			buf_len -= bytes;
-			buf += bytes;
-		}
+		ahci_prdt_fill(&dev->cmdlist[slotnum], dev->cmdtable,
+			       buf, buf_len);
 	}
 
-	return read_count;
+	return buf_len;
+}
+
+/** Find a free command slot below `slots`, returns -1 if all are busy. */
+int ahci_cmdslot_alloc(ahci_dev_t *const dev, const int slots)
+{
+	int slot;
+
+	for (slot = 0; slot < slots; ++slot) {
+		if (!(dev->slots_busy & (1u << slot)))
+			return slot;
+	}
+	return -1;
+}
+
+/**
+ * Prepare a command slot for a transfer from the device into buf.
+ *
+ * Unlike ahci_cmdslot_prepare(), the PRDT is built directly over buf
+ * (which has to have an even address) and each slot has its own command
+ * table, so multiple slots can be prepared and issued at a time.
+ *
+ * @return Number of bytes the command can transfer (at most buf_len).
+ */
+size_t ahci_cmdslot_setup(ahci_dev_t *const dev, const int slot,
+			  u8 *const buf, size_t buf_len)
+{
+	cmd_t *const cmd = &dev->cmdlist[slot];
+	cmdtable_t *const cmdtable = &dev->cmdtables[slot];
+
+	memset((void *)cmd, '\0', sizeof(*cmd));
+	memset((void *)cmdtable, '\0', sizeof(*cmdtable));
+	cmd->cmd = CMD_CFL(FIS_H2D_FIS_LEN);
+	cmd->cmdtable_base = virt_to_phys(cmdtable);
+
+	buf_len = MIN(buf_len, BYTES_PER_CMD);
+	if (buf_len > 0)
+		ahci_prdt_fill(cmd, cmdtable, buf, buf_len);
+	dev->slot_bytes[slot] = buf_len;
+
+	return buf_len;
+}
+
+/**
+ * Hand a prepared command slot to the controller without waiting for it.
+ *
+ * @queued Set for NCQ (FPDMA) commands, which have to be marked in PxSACT.
+ */
+int ahci_cmdslot_issue(ahci_dev_t *const dev, const int slot,
+		       const int queued)
+{
+	const u32 mask = 1u << slot;
+
+	if (!(dev->port->cmd_stat & HBA_PxCMD_CR))
+		return -1;
+
+	dev->slots_busy |= mask;
+	dev->slots_failed &= ~mask;
+
+	/* Writing zeros to PxSACT and PxCI has no effect. Don't use |= here,
+	   it could reissue a slot that completed since the register was read. */
+	if (queued)
+		dev->port->sata_active = mask;
+	dev->port->cmd_issue = mask;
+
+	return 0;
+}
+
+/** Wait until the command in the given slot has finished or failed. */
+static void ahci_cmdslot_wait(ahci_dev_t *const dev, const int slot)
+{
+	const u32 mask = 1u << slot;
+
+	int timeout = 50000; /* Time out after 50000 * 100us == 5s. */
+	while (((dev->port->cmd_issue | dev->port->sata_active) & mask) &&
+			!(dev->port->intr_status & HBA_PxIS_FATAL) &&
+			timeout--)
+		udelay(100);
+	if (timeout < 0)
+		printf("ahci: Timeout during command execution.\n");
+
+	const u32 intr_status = ahci_clear_status(dev->port, intr_status);
+	if ((timeout < 0) || (intr_status & (HBA_PxIS_FATAL | HBA_PxIS_PCS))) {
+		/* Restarting the command engine aborts all commands
+		   that are still in flight, not only the failed one. */
+		const u32 pending = dev->slots_busy &
+			(dev->port->cmd_issue | dev->port->sata_active);
+		ahci_error_recovery(dev, intr_status);
+		dev->slots_failed |= pending;
+	}
+}
+
+/**
+ * Wait for the command in the given slot and release the slot.
+ *
+ * @return Number of bytes transferred or -1 on error.
+ */
+ssize_t ahci_cmdslot_complete(ahci_dev_t *const dev, const int slot)
+{
+	const u32 mask = 1u << slot;
+
+	if ((slot < 0) || (slot >= 32) || !(dev->slots_busy & mask)) {
+		printf("ahci: No command outstanding in slot %d.\n", slot);
+		return -1;
+	}
+
+	if (!(dev->slots_failed & mask))
+		ahci_cmdslot_wait(dev, slot);
+
+	dev->slots_busy &= ~mask;
+	if (dev->slots_failed & mask) {
+		dev->slots_failed &= ~mask;
+		return -1;
+	}
+	/* The HBA doesn't have to update PRDBC for queued commands,
+	   but a command that completed without error transferred all. */
+	return dev->slot_bytes[slot];
 }
 
 int ahci_identify_device(ata_dev_t *const ata_dev, u8 *const buf)
@@ -109,6 +109,7 @@ typedef volatile struct {
 	hba_port_t ports[32];
 } hba_ctrl_t;
 
+#define HBA_CAPS_SNCQ		(1 << 30) /* SNCQ - Supports Native Cmd Queuing */
 #define HBA_CAPS_SSS		(1 << 27) /* SSS - Supports Staggered Spin-up */
 #define HBA_CAPS_NCS_SHIFT	8	/* NCS - Number of Command Slots */
 #define HBA_CAPS_NCS_MASK	(0x1f << HBA_CAPS_NCS_SHIFT)
@@ -155,6 +156,9 @@ typedef volatile struct {
 #define CMD_CFL_MASK	(0xf << CMD_CFL_SHIFT)
 #define CMD_CFL(x)	((((x) >> 2) << CMD_CFL_SHIFT) & CMD_CFL_MASK)
 
+#define PRDT_ENTRIES	8 /* Can be up to 65,535 prds,
+			     but implementation needs multiple of 128 bytes. */
+
 typedef volatile struct {
 	u8 fis[64];
 	u8 atapi_cmd[16];
@@ -163,12 +167,12 @@ typedef volatile struct {
 		u64 data_base;
 		u32 _reserved0;
 		u32 flags;
-	} prdt[8]; /* Can be up to 65,535 prds,
-		      but implementation needs multiple of 128 bytes. */
+	} prdt[PRDT_ENTRIES];
 } cmdtable_t;
 
-#define BYTES_PER_PRD_SHIFT	20
-#define BYTES_PER_PRD		(4 << 20)
+#define BYTES_PER_PRD_SHIFT	22
+#define BYTES_PER_PRD		(1 << BYTES_PER_PRD_SHIFT)
+#define BYTES_PER_CMD		(PRDT_ENTRIES * BYTES_PER_PRD)
 
 enum {
 	FIS_HOST_TO_DEVICE	= 0x27,
@@ -176,6 +180,7 @@ enum {
 #define FIS_H2D_CMD	(1 << 7)
 #define FIS_H2D_FIS_LEN	20
 #define FIS_H2D_DEV_LBA	(1 << 6)
+#define FIS_H2D_NCQ_TAG(x)	((x) << 3)
 
 #define PRD_TABLE_I		(1 << 31) /* I - Interrupt on Completion */
 #define PRD_TABLE_BYTES_MASK	0x3fffff
@@ -191,12 +196,17 @@ typedef struct {
 	hba_port_t *port;
 
 	cmd_t *cmdlist;
-	cmdtable_t *cmdtable;
+	cmdtable_t *cmdtable;	/* == &cmdtables[0] */
+	cmdtable_t *cmdtables;	/* one per command slot */
 	rcvd_fis_t *rcvd_fis;
 
 	u8 *buf, *user_buf;
 	int write_back;
 	size_t buflen;
+
+	u32 slots_busy;		/* issued and not yet completed by the caller */
+	u32 slots_failed;	/* aborted, result still to be collected */
+	u32 slot_bytes[32];
 } ahci_dev_t;
 
 /*
@@ -212,6 +222,16 @@ size_t ahci_cmdslot_prepare(ahci_dev_t *const dev,
 		   u8 *const user_buf, size_t buf_len,
 		   const int out);
 
+int ahci_cmdslot_alloc(ahci_dev_t *const dev, const int slots);
+
+size_t ahci_cmdslot_setup(ahci_dev_t *const dev, const int slot,
+			  u8 *const buf, const size_t buf_len);
+
+int ahci_cmdslot_issue(ahci_dev_t *const dev, const int slot,
+		       const int queued);
+
+ssize_t ahci_cmdslot_complete(ahci_dev_t *const dev, const int slot);
+
 int ahci_identify_device(ata_dev_t *const ata_dev, u8 *const buf);
 
 int ahci_error_recovery(ahci_dev_t *const dev, const u32 intr_status);
@@ -230,5 +250,11 @@ ssize_t ahci_ata_read_sectors(ata_dev_t *const ata_dev,
 		     const lba_t start, size_t count,
 		     u8 *const buf);
 
+int ahci_ata_submit_read(ata_dev_t *const ata_dev,
+			 const lba_t start, size_t count,
+			 u8 *const buf);
+
+ssize_t ahci_ata_complete_read(ata_dev_t *const ata_dev, const int tag);
+
 
 #endif /* _AHCI_PRIVATE_H */
@@ -136,6 +136,40 @@ static ssize_t ata_read512(storage_dev_t *_dev,
 	}
 }
 
+static int ata_submit_read512(storage_dev_t *_dev,
+			      const lba_t start, const size_t count,
+			      unsigned char *const buf)
+{
+	ata_dev_t *const dev = (ata_dev_t *)_dev;
+
+	if (dev->sector_size == 512) {
+		return dev->submit_read_sectors(dev, start, count, buf);
+	} else if (dev->sector_size > 512) {
+		const size_t mask = (dev->sector_size >> 9) - 1;
+		if ((start & mask) || (count & mask)) {
+			printf("ata: Queued reads have to be sector aligned.\n");
+			return -1;
+		}
+		const size_t shift = dev->sector_size_shift - 9;
+		return dev->submit_read_sectors(dev,
+				start >> shift, count >> shift, buf);
+	} else {
+		printf("ata: No support for sectors smaller than 512 bytes.\n");
+		return -1;
+	}
+}
+
+static ssize_t ata_complete_read512(storage_dev_t *_dev, const int tag)
+{
+	ata_dev_t *const dev = (ata_dev_t *)_dev;
+
+	const ssize_t ret = dev->complete_read(dev, tag);
+	if (ret < 0)
+		return ret;
+	else
+		return ret << (dev->sector_size_shift - 9);
+}
+
 static ssize_t ata_write512(storage_dev_t *const dev,
 			    const lba_t start, const size_t count,
 			    const unsigned char *const buf)
@@ -148,6 +182,10 @@ void ata_initialize_storage_ops(ata_dev_t *const dev)
 {
 	dev->storage_dev.read_blocks512 = ata_read512;
 	dev->storage_dev.write_blocks512 = ata_write512;
+	if (dev->submit_read_sectors && dev->complete_read) {
+		dev->storage_dev.submit_read512 = ata_submit_read512;
+		dev->storage_dev.complete_read512 = ata_complete_read512;
+	}
 }
 
 int ata_set_sector_size(ata_dev_t *const dev, u32 sector_size)
@@ -223,6 +261,16 @@ int ata_attach_device(ata_dev_t *const dev, const storage_port_t port_type)
 	dev->read_cmd = ATA_READ_DMA;
 #endif
 
+	if ((dev->queue_depth > 1) && (id[ATA_ID_SATA_CAPS] & (1 << 8))) {
+		const size_t depth = (id[ATA_ID_QUEUE_DEPTH] & 0x1f) + 1;
+		dev->queue_depth = MIN(dev->queue_depth, depth);
+		printf("ata: NCQ enabled (queue depth %zu).\n",
+		       dev->queue_depth);
+		dev->read_cmd = ATA_READ_FPDMA_QUEUED;
+	} else {
+		dev->queue_depth = 1;
+	}
+
 	if (ata_decode_sector_size(dev, id))
 		return -1;
 
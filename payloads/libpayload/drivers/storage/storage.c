@@ -102,6 +102,52 @@ ssize_t storage_read_blocks512(const size_t dev_num,
 		return -1;
 }
 
+/**
+ * Start reading 512-byte blocks
+ *
+ * Starts reading count blocks of 512 bytes from block start of drive
+ * dev_num into buf and returns without waiting for the data. Several
+ * reads can be in flight at a time, as many as the drive and its
+ * controller can queue. Every successful submission has to be followed
+ * by a call to storage_complete_read_blocks512() with the returned tag.
+ * A single read may cover fewer blocks than requested, the actual number
+ * is returned on completion.
+ *
+ * @dev_num device number counted from 0
+ * @start number of first block to read from
+ * @count number of blocks to read
+ * @buf buffer where the read data should be written, must stay valid
+ *      until the read is completed
+ * @return a tag for the read, or -1 if the device doesn't support
+ *         queued reads or no more reads can be queued right now
+ */
+int storage_submit_read_blocks512(const size_t dev_num,
+				  const lba_t start, const size_t count,
+				  unsigned char *const buf)
+{
+	if ((dev_num < dev_count) && devices[dev_num]->submit_read512)
+		return devices[dev_num]->submit_read512(
+				devices[dev_num], start, count, buf);
+	else
+		return -1;
+}
+
+/**
+ * Wait for a read started by storage_submit_read_blocks512()
+ *
+ * @dev_num device number counted from 0
+ * @tag tag returned on submission
+ * @return number of blocks read or -1 on error
+ */
+ssize_t storage_complete_read_blocks512(const size_t dev_num, const int tag)
+{
+	if ((dev_num < dev_count) && devices[dev_num]->complete_read512)
+		return devices[dev_num]->complete_read512(
+				devices[dev_num], tag);
+	else
+		return -1;
+}
+
 /**
  * Initializes storage controllers
  *
@@ -89,87 +89,120 @@ ehci_rh_hand_over_port (usbdev_t *dev, int port)
 	return;
 }
 
+/* Resets and attaches the device at `port`, once it's debounced. */
 static void
-ehci_rh_scanport (usbdev_t *dev, int port)
+ehci_rh_attach_port (usbdev_t *dev, int port)
 {
 	usb_speed port_speed;
 
-	if (RH_INST(dev)->devices[port]!=-1) {
-		usb_debug("Unregister device at port %x\n", port+1);
-		usb_detach_device(dev->controller, RH_INST(dev)->devices[port]);
-		RH_INST(dev)->devices[port]=-1;
+	if (!IS_ENABLED(CONFIG_LP_USB_EHCI_HOSTPC_ROOT_HUB_TT) &&
+			(RH_INST(dev)->ports[port] & P_LINE_STATUS) ==
+			P_LINE_STATUS_LOWSPEED) {
+		ehci_rh_hand_over_port(dev, port);
+		return;
 	}
-	/* device connected, handle */
-	if (RH_INST(dev)->ports[port] & P_CURR_CONN_STATUS) {
-		mdelay(100); // usb20 spec 9.1.2
-		if (!IS_ENABLED(CONFIG_LP_USB_EHCI_HOSTPC_ROOT_HUB_TT) &&
-				(RH_INST(dev)->ports[port] & P_LINE_STATUS) ==
-				P_LINE_STATUS_LOWSPEED) {
-			ehci_rh_hand_over_port(dev, port);
-			return;
-		}
 
-		/* Deassert enable, assert reset.  These must change
-		 * atomically.
-		 */
-		RH_INST(dev)->ports[port] = (RH_INST(dev)->ports[port] & ~P_PORT_ENABLE) | P_PORT_RESET;
+	/* Deassert enable, assert reset.  These must change
+	 * atomically.
+	 */
+	RH_INST(dev)->ports[port] = (RH_INST(dev)->ports[port] & ~P_PORT_ENABLE) | P_PORT_RESET;
 
-		/* Wait a bit while reset is active (+1 to avoid Tegra race). */
-		mdelay(50 + 1); // usb20 spec 7.1.7.5 (TDRSTR)
+	/* Wait a bit while reset is active (+1 to avoid Tegra race). */
+	mdelay(50 + 1); // usb20 spec 7.1.7.5 (TDRSTR)
 
-		/* Deassert reset. */
-		RH_INST(dev)->ports[port] &= ~P_PORT_RESET;
+	/* Deassert reset. */
+	RH_INST(dev)->ports[port] &= ~P_PORT_RESET;
 
-		/* Wait max. 2ms (ehci spec 2.3.9) for flag change to finish. */
-		int timeout = 20; /* time out after 20 * 100us == 2ms */
-		while ((RH_INST(dev)->ports[port] & P_PORT_RESET) && timeout--)
-			udelay(100);
-		if (RH_INST(dev)->ports[port] & P_PORT_RESET) {
-			usb_debug("Error: ehci_rh: port reset timed out.\n");
-			return;
-		}
+	/* Wait max. 2ms (ehci spec 2.3.9) for flag change to finish. */
+	int timeout = 20; /* time out after 20 * 100us == 2ms */
+	while ((RH_INST(dev)->ports[port] & P_PORT_RESET) && timeout--)
+		udelay(100);
+	if (RH_INST(dev)->ports[port] & P_PORT_RESET) {
+		usb_debug("Error: ehci_rh: port reset timed out.\n");
+		return;
+	}
+
+	mdelay(10); /* TRSTRCY (USB 2.0 spec 7.1.7.5) */
+
+	/* If the host controller enabled the port, it's a high-speed
+	 * device, otherwise it's full-speed.
+	 */
+	if (!(RH_INST(dev)->ports[port] & P_PORT_ENABLE)) {
+		ehci_rh_hand_over_port(dev, port);
+		return;
+	}
+	if (IS_ENABLED(CONFIG_LP_USB_EHCI_HOSTPC_ROOT_HUB_TT)) {
+		port_speed = (usb_speed)
+			((EHCI_INST(dev->controller)->operation->hostpc
+			>> 25) & 0x03);
+	} else {
+		usb_debug("port %x hosts a USB2 device\n", port+1);
+		port_speed = HIGH_SPEED;
+	}
+	RH_INST(dev)->devices[port] = usb_attach_device(dev->controller
+		, dev->address, port, port_speed);
+
+	/* RW/C register, so clear it by writing 1 */
+	RH_INST(dev)->ports[port] |= P_CONN_STATUS_CHANGE;
+}
 
-		mdelay(10); /* TRSTRCY (USB 2.0 spec 7.1.7.5) */
+/*
+ * Scans all ports set in the `scan` bitmask. Connections are debounced
+ * together, but ports are reset one after another: the root hub forwards
+ * transfers to address 0 to every enabled port.
+ */
+static void
+ehci_rh_scanports (usbdev_t *dev, u32 scan)
+{
+	int port, connected = 0;
 
-		/* If the host controller enabled the port, it's a high-speed
-		 * device, otherwise it's full-speed.
-		 */
-		if (!(RH_INST(dev)->ports[port] & P_PORT_ENABLE)) {
-			ehci_rh_hand_over_port(dev, port);
-			return;
+	for (port = 0; port < RH_INST(dev)->n_ports; port++) {
+		if (!(scan & (1 << port)))
+			continue;
+		if (RH_INST(dev)->devices[port]!=-1) {
+			usb_debug("Unregister device at port %x\n", port+1);
+			usb_detach_device(dev->controller, RH_INST(dev)->devices[port]);
+			RH_INST(dev)->devices[port]=-1;
 		}
-		if (IS_ENABLED(CONFIG_LP_USB_EHCI_HOSTPC_ROOT_HUB_TT)) {
-			port_speed = (usb_speed)
-				((EHCI_INST(dev->controller)->operation->hostpc
-				>> 25) & 0x03);
+		if (RH_INST(dev)->ports[port] & P_CURR_CONN_STATUS)
+			connected = 1;
+	}
+
+	if (connected)
+		mdelay(100); // usb20 spec 9.1.2
+
+	for (port = 0; port < RH_INST(dev)->n_ports; port++) {
+		if (!(scan & (1 << port)))
+			continue;
+		/* device connected, handle */
+		if (RH_INST(dev)->ports[port] & P_CURR_CONN_STATUS) {
+			ehci_rh_attach_port(dev, port);
 		} else {
-			usb_debug("port %x hosts a USB2 device\n", port+1);
-			port_speed = HIGH_SPEED;
+			/* RW/C register, so clear it by writing 1 */
+			RH_INST(dev)->ports[port] |= P_CONN_STATUS_CHANGE;
 		}
-		RH_INST(dev)->devices[port] = usb_attach_device(dev->controller
-			, dev->address, port, port_speed);
 	}
-	/* RW/C register, so clear it by writing 1 */
-	RH_INST(dev)->ports[port] |= P_CONN_STATUS_CHANGE;
 }
 
-static int
+/* Returns a bitmask of the ports with connection changes. */
+static u32
 ehci_rh_report_port_changes (usbdev_t *dev)
 {
 	int i;
+	u32 changes = 0;
 	for (i=0; i<RH_INST(dev)->n_ports; i++) {
 		if (RH_INST(dev)->ports[i] & P_CONN_STATUS_CHANGE)
-			return i;
+			changes |= 1 << i;
 	}
-	return -1;
+	return changes;
 }
 
 static void
 ehci_rh_poll (usbdev_t *dev)
 {
-	int port;
-	while ((port = ehci_rh_report_port_changes (dev)) != -1)
-		ehci_rh_scanport (dev, port);
+	u32 changes;
+	while ((changes = ehci_rh_report_port_changes (dev)))
+		ehci_rh_scanports (dev, changes);
 }
 
 
@@ -203,8 +236,7 @@ ehci_rh_init (usbdev_t *dev)
 	dev->address = 0;
 	dev->hub = -1;
 	dev->port = -1;
-	for (i=0; i < RH_INST(dev)->n_ports; i++) {
+	for (i=0; i < RH_INST(dev)->n_ports; i++)
 		RH_INST(dev)->devices[i] = -1;
-		ehci_rh_scanport(dev, i);
-	}
+	ehci_rh_scanports(dev, (1 << RH_INST(dev)->n_ports) - 1);
 }
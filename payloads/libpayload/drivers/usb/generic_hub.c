@@ -60,39 +60,6 @@ generic_hub_destroy(usbdev_t *const dev)
 	free(hub);
 }
 
-static int
-generic_hub_debounce(usbdev_t *const dev, const int port)
-{
-	generic_hub_t *const hub = GEN_HUB(dev);
-
-	const int step_ms	= 1;	/* linux uses 25ms, we're busy anyway */
-	const int at_least_ms	= 100;	/* 100ms as in usb20 spec 9.1.2 */
-	const int timeout_ms	= 1500;	/* linux uses this value */
-
-	int total_ms = 0;
-	int stable_ms = 0;
-	while (stable_ms < at_least_ms && total_ms < timeout_ms) {
-		mdelay(step_ms);
-
-		const int changed = hub->ops->port_status_changed(dev, port);
-		const int connected = hub->ops->port_connected(dev, port);
-		if (changed < 0 || connected < 0)
-			return -1;
-
-		if (!changed && connected) {
-			stable_ms += step_ms;
-		} else {
-			usb_debug("generic_hub: Unstable connection at %d\n",
-				  port);
-			stable_ms = 0;
-		}
-		total_ms += step_ms;
-	}
-	if (total_ms >= timeout_ms)
-		usb_debug("generic_hub: Debouncing timed out at %d\n", port);
-	return 0; /* ignore timeouts, try to always go on */
-}
-
 int
 generic_hub_wait_for_port(usbdev_t *const dev, const int port,
 			  const int wait_for,
@@ -146,14 +113,15 @@ generic_hub_detach_dev(usbdev_t *const dev, const int port)
 	return 0;
 }
 
+/*
+ * Resets the port if necessary and attaches the device behind it. Called
+ * once the connection is debounced.
+ */
 static int
 generic_hub_attach_dev(usbdev_t *const dev, const int port)
 {
 	generic_hub_t *const hub = GEN_HUB(dev);
 
-	if (generic_hub_debounce(dev, port) < 0)
-		return -1;
-
 	if (hub->ops->reset_port) {
 		if (hub->ops->reset_port(dev, port) < 0)
 			return -1;
@@ -180,26 +148,145 @@ generic_hub_attach_dev(usbdev_t *const dev, const int port)
 	return 0;
 }
 
-int
-generic_hub_scanport(usbdev_t *const dev, const int port)
+enum {
+	PORT_IDLE = 0,
+	PORT_DEBOUNCING,
+};
+
+/*
+ * Debounces the connections of all ports marked PORT_DEBOUNCING in `state`
+ * at once and attaches each device as soon as its port is stable. Ports are
+ * still reset and addressed one after another, since devices in the default
+ * state share address 0 behind most hubs. A failing port doesn't stop the
+ * others from being attached.
+ */
+static int
+generic_hub_attach_devs(usbdev_t *const dev, u8 *const state)
 {
 	generic_hub_t *const hub = GEN_HUB(dev);
 
-	if (hub->ports[port] >= 0) {
-		usb_debug("generic_hub: Detachment at port %d\n", port);
+	const uint64_t at_least_us	= 100 * 1000;	/* usb20 spec 9.1.2 */
+	const uint64_t timeout_us	= 1500 * 1000;	/* linux uses this */
 
-		const int ret = generic_hub_detach_dev(dev, port);
-		if (ret < 0)
-			return ret;
+	const uint64_t start = timer_us(0);
+	uint64_t *const stable_since = malloc(sizeof(*stable_since) *
+					      (hub->num_ports + 1));
+	if (!stable_since) {
+		usb_debug("generic_hub: ERROR: Out of memory\n");
+		return -1;
 	}
 
-	if (hub->ops->port_connected(dev, port)) {
-		usb_debug("generic_hub: Attachment at port %d\n", port);
+	int port, pending = 0;
+	for (port = 1; port <= hub->num_ports; ++port) {
+		stable_since[port] = start;
+		pending += state[port] == PORT_DEBOUNCING;
+	}
 
-		return generic_hub_attach_dev(dev, port);
+	int ret = 0;
+	while (pending) {
+		/* linux uses 25ms steps, we're busy anyway */
+		mdelay(1);
+		for (port = 1; port <= hub->num_ports; ++port) {
+			if (state[port] != PORT_DEBOUNCING)
+				continue;
+
+			const int changed =
+				hub->ops->port_status_changed(dev, port);
+			const int connected =
+				hub->ops->port_connected(dev, port);
+			if (changed < 0 || connected < 0) {
+				/* give up on this port, go on with the rest */
+				state[port] = PORT_IDLE;
+				--pending;
+				ret = -1;
+				continue;
+			}
+
+			const uint64_t now = timer_us(0);
+			if (changed || !connected) {
+				usb_debug("generic_hub: Unstable connection "
+					  "at %d\n", port);
+				stable_since[port] = now;
+			}
+			if (now - stable_since[port] < at_least_us &&
+			    now - start < timeout_us)
+				continue;
+			if (now - start >= timeout_us)
+				usb_debug("generic_hub: Debouncing timed out "
+					  "at %d\n", port);
+
+			/* ignore timeouts, try to always go on */
+			state[port] = PORT_IDLE;
+			--pending;
+			if (generic_hub_attach_dev(dev, port) < 0) {
+				usb_debug("generic_hub: Attaching the device at "
+					  "port %d failed\n", port);
+				ret = -1;
+				continue;
+			}
+			usb_debug("generic_hub: Port %d stable after %lluus, "
+				  "attached after %lluus\n", port,
+				  stable_since[port] - start, timer_us(start));
+		}
 	}
 
-	return 0;
+	free(stable_since);
+	return ret;
+}
+
+int
+generic_hub_scanports(usbdev_t *const dev, const u8 *const scan)
+{
+	generic_hub_t *const hub = GEN_HUB(dev);
+	int port, ret = 0;
+
+	u8 *const state = calloc(hub->num_ports + 1, sizeof(*state));
+	if (!state) {
+		usb_debug("generic_hub: ERROR: Out of memory\n");
+		return -1;
+	}
+
+	for (port = 1; port <= hub->num_ports; ++port) {
+		if (!scan[port])
+			continue;
+
+		if (hub->ports[port] >= 0) {
+			usb_debug("generic_hub: Detachment at port %d\n",
+				  port);
+			generic_hub_detach_dev(dev, port);
+		}
+
+		const int connected = hub->ops->port_connected(dev, port);
+		if (connected < 0) {
+			ret = -1;
+		} else if (connected) {
+			usb_debug("generic_hub: Attachment at port %d\n",
+				  port);
+			state[port] = PORT_DEBOUNCING;
+		}
+	}
+
+	if (generic_hub_attach_devs(dev, state) < 0)
+		ret = -1;
+	free(state);
+	return ret;
+}
+
+int
+generic_hub_scanport(usbdev_t *const dev, const int port)
+{
+	generic_hub_t *const hub = GEN_HUB(dev);
+	int ret;
+
+	u8 *const scan = calloc(hub->num_ports + 1, sizeof(*scan));
+	if (!scan) {
+		usb_debug("generic_hub: ERROR: Out of memory\n");
+		return -1;
+	}
+	scan[port] = 1;
+	ret = generic_hub_scanports(dev, scan);
+	free(scan);
+	return ret;
 }
 
 static void
@@ -213,17 +300,29 @@ generic_hub_poll(usbdev_t *const dev)
 			hub->ops->hub_status_changed(dev) != 1)
 		return;
 
-	int port;
+	u8 *const scan = calloc(hub->num_ports + 1, sizeof(*scan));
+	if (!scan) {
+		usb_debug("generic_hub: ERROR: Out of memory\n");
+		return;
+	}
+
+	int port, changed = 0;
 	for (port = 1; port <= hub->num_ports; ++port) {
 		const int ret = hub->ops->port_status_changed(dev, port);
 		if (ret < 0) {
-			return;
+			goto out;
 		} else if (ret == 1) {
 			usb_debug("generic_hub: Port change at %d\n", port);
-			if (generic_hub_scanport(dev, port) < 0)
-				return;
+			scan[port] = 1;
+			changed = 1;
 		}
 	}
+
+	/* Enumerate all changed ports together */
+	if (changed)
+		generic_hub_scanports(dev, scan);
+out:
+	free(scan);
 }
 
 int
@@ -78,6 +78,9 @@ int generic_hub_wait_for_port(usbdev_t *const dev, const int port,
 			      int timeout_steps, const int step_us);
 int  generic_hub_resetport(usbdev_t *, int port);
 int  generic_hub_scanport(usbdev_t *, int port);
+/* scans all ports `p` with scan[p] != 0 concurrently (scan has num_ports + 1
+   entries) */
+int  generic_hub_scanports(usbdev_t *, const u8 *scan);
 /* the provided generic_hub_ops struct has to be static */
 int generic_hub_init(usbdev_t *, int num_ports, const generic_hub_ops_t *);
 
@@ -97,57 +97,79 @@ ohci_rh_disable_port (usbdev_t *dev, int port)
 	}
 }
 
+/*
+ * Scans all ports set in the `scan` bitmask. Connections are debounced
+ * together, then each port is reset and its device attached before the
+ * next one, so only one device at a time listens to address 0.
+ */
 static void
-ohci_rh_scanport (usbdev_t *dev, int port)
+ohci_rh_scanports (usbdev_t *dev, u32 scan)
 {
-	if (port >= RH_INST(dev)->numports) {
-		usb_debug("Invalid port %d\n", port);
-		return;
-	}
+	int port, connected = 0;
 
-	/* device registered, and device change logged, so something must have happened */
-	if (RH_INST (dev)->port[port] != -1) {
-		usb_detach_device(dev->controller, RH_INST (dev)->port[port]);
-		RH_INST (dev)->port[port] = -1;
+	for (port = 0; port < RH_INST(dev)->numports; port++) {
+		if (!(scan & (1 << port)))
+			continue;
+
+		/* device registered, and device change logged, so something must have happened */
+		if (RH_INST (dev)->port[port] != -1) {
+			usb_detach_device(dev->controller, RH_INST (dev)->port[port]);
+			RH_INST (dev)->port[port] = -1;
+		}
+
+		/* no device attached
+		   previously registered devices are detached, nothing left to do */
+		if (!(OHCI_INST(dev->controller)->opreg->HcRhPortStatus[port] & CurrentConnectStatus))
+			continue;
+
+		OHCI_INST (dev->controller)->opreg->HcRhPortStatus[port] = ConnectStatusChange; // clear port state change
+		connected = 1;
 	}
 
-	/* no device attached
-	   previously registered devices are detached, nothing left to do */
-	if (!(OHCI_INST(dev->controller)->opreg->HcRhPortStatus[port] & CurrentConnectStatus))
+	if (!connected)
 		return;
 
-	OHCI_INST (dev->controller)->opreg->HcRhPortStatus[port] = ConnectStatusChange; // clear port state change
-	ohci_rh_enable_port (dev, port);
+	mdelay(100); // wait for signal to stabilize (usb20 spec 9.1.2)
 
-	mdelay(100); // wait for signal to stabilize
+	for (port = 0; port < RH_INST(dev)->numports; port++) {
+		if (!(scan & (1 << port)))
+			continue;
+		if (!(OHCI_INST(dev->controller)->opreg->HcRhPortStatus[port] & CurrentConnectStatus))
+			continue;
 
-	if (!(OHCI_INST(dev->controller)->opreg->HcRhPortStatus[port] & PortEnableStatus)) {
-		usb_debug ("port enable failed\n");
-		return;
-	}
+		ohci_rh_enable_port (dev, port);
 
-	usb_speed speed = (OHCI_INST(dev->controller)->opreg->HcRhPortStatus[port] & LowSpeedDeviceAttached) != 0;
-	RH_INST (dev)->port[port] = usb_attach_device(dev->controller, dev->address, port, speed);
+		mdelay(10); // reset recovery time (usb20 spec 7.1.7.5)
+
+		if (!(OHCI_INST(dev->controller)->opreg->HcRhPortStatus[port] & PortEnableStatus)) {
+			usb_debug ("port enable failed\n");
+			continue;
+		}
+
+		usb_speed speed = (OHCI_INST(dev->controller)->opreg->HcRhPortStatus[port] & LowSpeedDeviceAttached) != 0;
+		RH_INST (dev)->port[port] = usb_attach_device(dev->controller, dev->address, port, speed);
+	}
 }
 
-static int
+/* Returns a bitmask of the ports with connection changes. */
+static u32
 ohci_rh_report_port_changes (usbdev_t *dev)
 {
 	ohci_t *const ohcic = OHCI_INST (dev->controller);
 
 	int i;
+	u32 changes = 0;
 
 	for (i = 0; i < RH_INST(dev)->numports; i++) {
 		// maybe detach+attach happened between two scans?
 		if (ohcic->opreg->HcRhPortStatus[i] & ConnectStatusChange) {
 			ohcic->opreg->HcRhPortStatus[i] = ConnectStatusChange;
 			usb_debug("attachment change on port %d\n", i);
-			return i;
+			changes |= 1 << i;
 		}
 	}
 
-	// no change
-	return -1;
+	return changes;
 }
 
 static void
@@ -164,7 +186,7 @@ ohci_rh_poll (usbdev_t *dev)
 {
 	ohci_t *const ohcic = OHCI_INST (dev->controller);
 
-	int port;
+	u32 changes;
 
 	/* Check if anything changed. */
 	if (!(ohcic->opreg->HcInterruptStatus & RootHubStatusChange))
@@ -173,8 +195,8 @@ ohci_rh_poll (usbdev_t *dev)
 	usb_debug("root hub status change\n");
 
 	/* Scan ports with changed connection status. */
-	while ((port = ohci_rh_report_port_changes (dev)) != -1)
-		ohci_rh_scanport (dev, port);
+	while ((changes = ohci_rh_report_port_changes (dev)))
+		ohci_rh_scanports (dev, changes);
 }
 
 void
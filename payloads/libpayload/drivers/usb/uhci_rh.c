@@ -103,74 +103,72 @@ uhci_rh_disable_port (usbdev_t *dev, int port)
 		usb_debug("Warning: uhci_rh: port disabling timed out.\n");
 }
 
+/*
+ * Scans the ports (1 and 2) with scan[port - 1] set. Connections are
+ * debounced together, then each port is reset and its device attached
+ * before the next one, so only one device at a time listens to address 0.
+ */
 static void
-uhci_rh_scanport (usbdev_t *dev, int port)
+uhci_rh_scanports (usbdev_t *dev, const int *scan)
 {
-	int portsc, offset;
-	if (port == 1) {
-		portsc = PORTSC1;
-		offset = 0;
-	} else if (port == 2) {
-		portsc = PORTSC2;
-		offset = 1;
-	} else {
-		usb_debug("Invalid port %d\n", port);
-		return;
-	}
-	int devno = RH_INST (dev)->port[offset];
-	if ((devno != -1) && (dev->controller->devices[devno] != 0)) {
-		usb_detach_device(dev->controller, devno);
-		RH_INST (dev)->port[offset] = -1;
+	int port, offset;
+
+	for (offset = 0; offset < 2; offset++) {
+		if (!scan[offset])
+			continue;
+		const int portsc = offset ? PORTSC2 : PORTSC1;
+		int devno = RH_INST (dev)->port[offset];
+		if ((devno != -1) && (dev->controller->devices[devno] != 0)) {
+			usb_detach_device(dev->controller, devno);
+			RH_INST (dev)->port[offset] = -1;
+		}
+		uhci_reg_write16(dev->controller, portsc,
+				 uhci_reg_read16(dev->controller, portsc) | (1 << 3) | (1 << 2));	// clear port state change, enable port
 	}
-	uhci_reg_write16(dev->controller, portsc,
-			 uhci_reg_read16(dev->controller, portsc) | (1 << 3) | (1 << 2));	// clear port state change, enable port
 
 	mdelay(100); // wait for signal to stabilize
 
-	if ((uhci_reg_read16 (dev->controller, portsc) & 1) != 0) {
-		// device attached
+	for (offset = 0; offset < 2; offset++) {
+		if (!scan[offset])
+			continue;
+		const int portsc = offset ? PORTSC2 : PORTSC1;
+		port = offset + 1;
+		if ((uhci_reg_read16 (dev->controller, portsc) & 1) != 0) {
+			// device attached
 
-		uhci_rh_disable_port (dev, port);
-		uhci_rh_enable_port (dev, port);
+			uhci_rh_disable_port (dev, port);
+			uhci_rh_enable_port (dev, port);
 
-		usb_speed speed = ((uhci_reg_read16 (dev->controller, portsc) >> 8) & 1);
+			usb_speed speed = ((uhci_reg_read16 (dev->controller, portsc) >> 8) & 1);
 
-		RH_INST (dev)->port[offset] = usb_attach_device(dev->controller, dev->address, portsc, speed);
+			RH_INST (dev)->port[offset] = usb_attach_device(dev->controller, dev->address, portsc, speed);
+		}
 	}
 }
 
+/* Returns 1 if the connection at `port` (1 or 2) changed. */
 static int
-uhci_rh_report_port_changes (usbdev_t *dev)
+uhci_rh_port_changed (usbdev_t *dev, int port)
 {
+	const int portsc = port == 2 ? PORTSC2 : PORTSC1;
 	u16 stored, real;
 
-	stored = (RH_INST (dev)->port[0] == -1);
-	real = ((uhci_reg_read16 (dev->controller, PORTSC1) & 1) == 0);
+	stored = (RH_INST (dev)->port[port - 1] == -1);
+	real = ((uhci_reg_read16 (dev->controller, portsc) & 1) == 0);
 	if (stored != real) {
-		usb_debug("change on port 1\n");
+		usb_debug("change on port %d\n", port);
 		return 1;
 	}
 
-	stored = (RH_INST (dev)->port[1] == -1);
-	real = ((uhci_reg_read16 (dev->controller, PORTSC2) & 1) == 0);
-	if (stored != real) {
-		usb_debug("change on port 2\n");
-		return 2;
-	}
-
 	// maybe detach+attach happened between two scans?
 
-	if ((uhci_reg_read16 (dev->controller, PORTSC1) & 2) > 0) {
-		usb_debug("possibly re-attached on port 1\n");
+	if ((uhci_reg_read16 (dev->controller, portsc) & 2) > 0) {
+		usb_debug("possibly re-attached on port %d\n", port);
 		return 1;
 	}
-	if ((uhci_reg_read16 (dev->controller, PORTSC2) & 2) > 0) {
-		usb_debug("possibly re-attached on port 2\n");
-		return 2;
-	}
 
 	// no change
-	return -1;
+	return 0;
 }
 
 static void
@@ -186,9 +184,14 @@ uhci_rh_destroy (usbdev_t *dev)
 static void
 uhci_rh_poll (usbdev_t *dev)
 {
-	int port;
-	while ((port = uhci_rh_report_port_changes (dev)) != -1)
-		uhci_rh_scanport (dev, port);
+	int scan[2];
+	while (1) {
+		scan[0] = uhci_rh_port_changed (dev, 1);
+		scan[1] = uhci_rh_port_changed (dev, 2);
+		if (!scan[0] && !scan[1])
+			break;
+		uhci_rh_scanports (dev, scan);
+	}
 }
 
 void
@@ -160,17 +160,16 @@ static const generic_hub_ops_t usb_hub_ops = {
 
 /* Clear CSC if set and enumerate port if it's connected regardless of change
    bits. Some broken hubs don't set CSC if already connected during reset. */
-static void
+static int
 usb_hub_port_initialize(usbdev_t *const dev, const int port)
 {
 	unsigned short buf[2];
 	int ret = get_status(dev, port, DR_PORT, sizeof(buf), buf);
 	if (ret < 0)
-		return;
+		return 0;
 	if (buf[1] & PORT_CONNECTION)
 		clear_feature(dev, port, SEL_C_PORT_CONNECTION, DR_PORT);
-	if (buf[0] & PORT_CONNECTION)
-		generic_hub_scanport(dev, port);
+	return !!(buf[0] & PORT_CONNECTION);
 }
 
 void
@@ -190,7 +189,17 @@ usb_hub_init(usbdev_t *const dev)
 	if (generic_hub_init(dev, desc.bNbrPorts, &usb_hub_ops) < 0)
 		return;
 
+	const int num_ports = GEN_HUB(dev)->num_ports;
+	u8 *const scan = calloc(num_ports + 1, sizeof(*scan));
+	if (!scan) {
+		usb_debug("usbhub: ERROR: Out of memory\n");
+		return;
+	}
+
+	/* Enumerate everything that's already connected together */
 	int port;
-	for (port = 1; port <= GEN_HUB(dev)->num_ports; ++port)
-		usb_hub_port_initialize(dev, port);
+	for (port = 1; port <= num_ports; ++port)
+		scan[port] = usb_hub_port_initialize(dev, port);
+	generic_hub_scanports(dev, scan);
+	free(scan);
 }
@@ -368,6 +368,87 @@ readwrite_chunk (usbdev_t *dev, int start, int n, cbw_direction dir, u8 *buf)
 		!= MSC_COMMAND_OK ? 1 : 0;
 }
 
+/*
+ * Like readwrite_chunk, but queues the command, all data transfers and the
+ * status transfer at once on host controllers that support it, so that the
+ * device never waits for the host between them. The data phase is split
+ * into MAX_CHUNK_BYTES transfers. buf has to be DMA coherent.
+ *
+ * @return 0 on success, 1 on failure
+ */
+static int
+readwrite_chunk_queued (usbdev_t *dev, int start, int n, cbw_direction dir,
+			u8 *buf)
+{
+	hci_t *const hc = dev->controller;
+	usbmsc_inst_t *const msc = MSC_INST (dev);
+	endpoint_t *const data_ep =
+		dir == cbw_direction_data_in ? msc->bulk_in : msc->bulk_out;
+	const int len = n * msc->blocksize;
+	int off, ret, transferred = 0;
+	cmdblock_t cb;
+
+	/* CBW and CSW are accessed by the controller, too */
+	cbw_t *const cbw = dma_memalign (64, sizeof (cbw_t) + sizeof (csw_t));
+	if (!cbw)
+		return 1;
+	csw_t *const csw = (csw_t *) (cbw + 1);
+
+	memset (&cb, 0, sizeof (cb));
+	cb.command = dir == cbw_direction_data_in ? 0x28 : 0x2a;
+	cb.block = htonl (start);
+	cb.numblocks = htonw (n);
+	wrap_cbw (cbw, len, dir, (u8 *) &cb, sizeof (cb), msc->lun);
+
+	if (hc->bulk_submit (msc->bulk_out, sizeof (*cbw), (u8 *) cbw))
+		goto fallback;
+	for (off = 0; off < len; off += MAX_CHUNK_BYTES) {
+		if (hc->bulk_submit (data_ep, MIN (len - off, MAX_CHUNK_BYTES),
+				     buf + off))
+			goto cancel;
+	}
+	if (hc->bulk_submit (msc->bulk_in, sizeof (*csw), (u8 *) csw))
+		goto cancel;
+
+	if (hc->bulk_reap (msc->bulk_out) != sizeof (*cbw))
+		goto cancel;
+	for (off = 0; off < len; off += MAX_CHUNK_BYTES) {
+		ret = hc->bulk_reap (data_ep);
+		/* A short transfer would let the CSW end up in the data. */
+		if (ret != MIN (len - off, MAX_CHUNK_BYTES))
+			goto cancel;
+		transferred += ret;
+	}
+	if (hc->bulk_reap (msc->bulk_in) != sizeof (*csw))
+		goto cancel;
+
+	ret = MSC_COMMAND_OK;
+	if (csw->dCSWSignature != csw_signature || csw->dCSWTag != tag ||
+	    csw->bCSWStatus == 2)
+		ret = reset_transport (dev);
+	else if (csw->bCSWStatus != 0) {
+		ret = request_sense (dev);
+		if (!ret)
+			ret = MSC_COMMAND_FAIL;
+	} else if (csw->dCSWDataResidue != 0)
+		ret = MSC_COMMAND_FAIL;
+
+	free (cbw);
+	return ret != MSC_COMMAND_OK;
+
+cancel:
+	hc->bulk_cancel (msc->bulk_out);
+	hc->bulk_cancel (data_ep);
+	hc->bulk_cancel (msc->bulk_in);
+	free (cbw);
+	usb_debug ("Queued transfer failed after %d bytes.\n", transferred);
+	return reset_transport (dev) != MSC_COMMAND_OK;
+
+fallback:
+	free (cbw);
+	return readwrite_chunk (dev, start, n, dir, buf);
+}
+
 /**
  * Reads or writes a number of sequential blocks on a USB storage device
  * that is split into MAX_CHUNK_BYTES size requests.
@@ -387,27 +468,41 @@ readwrite_chunk (usbdev_t *dev, int start, int n, cbw_direction dir, u8 *buf)
 int
 readwrite_blocks (usbdev_t *dev, int start, int n, cbw_direction dir, u8 *buf)
 {
-	int chunk_size = MAX_CHUNK_BYTES / MSC_INST(dev)->blocksize;
-	int chunk;
+	int (*rw_chunk) (usbdev_t *, int, int, cbw_direction, u8 *) =
+		readwrite_chunk;
+	int chunk_bytes = MAX_CHUNK_BYTES;
+	int chunk_size, chunk;
+	const uint64_t start_us = timer_us (0);
+
+	if (dev->controller->bulk_submit && dma_coherent (buf)) {
+		rw_chunk = readwrite_chunk_queued;
+		chunk_bytes = CONFIG_LP_USB_MSC_QUEUED_TRANSFER_KB * KiB;
+	}
+	chunk_size = chunk_bytes / MSC_INST(dev)->blocksize;
 
 	/* Read as many full chunks as needed. */
 	for (chunk = 0; chunk < (n / chunk_size); chunk++) {
-		if (readwrite_chunk (dev, start + (chunk * chunk_size),
-				     chunk_size, dir,
-				     buf + (chunk * MAX_CHUNK_BYTES))
+		if (rw_chunk (dev, start + (chunk * chunk_size),
+			      chunk_size, dir,
+			      buf + (chunk * chunk_bytes))
 		    != MSC_COMMAND_OK)
 			return 1;
 	}
 
 	/* Read any remaining partial chunk at the end. */
 	if (n % chunk_size) {
-		if (readwrite_chunk (dev, start + (chunk * chunk_size),
-				     n % chunk_size, dir,
-				     buf + (chunk * MAX_CHUNK_BYTES))
+		if (rw_chunk (dev, start + (chunk * chunk_size),
+			      n % chunk_size, dir,
+			      buf + (chunk * chunk_bytes))
 		    != MSC_COMMAND_OK)
 			return 1;
 	}
 
+	const uint64_t us = timer_us (start_us);
+	usb_debug ("%s %d blocks in %lluus (%llu KiB/s)\n",
+		   dir == cbw_direction_data_in ? "Read" : "Wrote", n, us,
+		   us ? (uint64_t)n * MSC_INST(dev)->blocksize * 1000000
+			/ KiB / us : 0);
 	return 0;
 }
 
@@ -41,6 +41,9 @@ static void xhci_reset (hci_t *controller);
 static void xhci_reinit (hci_t *controller);
 static void xhci_shutdown (hci_t *controller);
 static int xhci_bulk (endpoint_t *ep, int size, u8 *data, int finalize);
+static int xhci_bulk_submit(endpoint_t *ep, int size, u8 *data);
+static int xhci_bulk_reap(endpoint_t *ep);
+static void xhci_bulk_cancel(endpoint_t *ep);
 static int xhci_control (usbdev_t *dev, direction_t dir, int drlen, void *devreq,
 			 int dalen, u8 *data);
 static void* xhci_create_intr_queue (endpoint_t *ep, int reqsize, int reqcount, int reqtiming);
@@ -161,6 +164,9 @@ xhci_init (unsigned long physical_bar)
 	controller->init		= xhci_reinit;
 	controller->shutdown		= xhci_shutdown;
 	controller->bulk		= xhci_bulk;
+	controller->bulk_submit		= xhci_bulk_submit;
+	controller->bulk_reap		= xhci_bulk_reap;
+	controller->bulk_cancel		= xhci_bulk_cancel;
 	controller->control		= xhci_control;
 	controller->set_address		= xhci_set_address;
 	controller->finish_device_config= xhci_finish_device_config;
@@ -725,7 +731,6 @@ xhci_bulk(endpoint_t *const ep, const int size, u8 *const src,
 	const int slot_id = ep->dev->address;
 	const int ep_id = xhci_ep_id(ep);
 	epctx_t *const epctx = xhci->dev[slot_id].ctx.ep[ep_id];
-	transfer_ring_t *const tr = xhci->dev[slot_id].transfer_rings[ep_id];
 
 	const size_t off = (size_t)data & 0xffff;
 	if ((off + size) > ((TRANSFER_RING_SIZE - 2) << 16)) {
@@ -733,6 +738,12 @@ xhci_bulk(endpoint_t *const ep, const int size, u8 *const src,
 		return -1;
 	}
 
+	const bulkq_t *const bulkq = xhci->dev[slot_id].bulk_queues[ep_id];
+	if (bulkq && bulkq->count) {
+		xhci_debug("Endpoint has queued transfers\n");
+		return -1;
+	}
+
 	if (!dma_coherent(src)) {
 		data = xhci->dma_buffer;
 		if (size > DMA_SIZE) {
@@ -743,26 +754,21 @@ xhci_bulk(endpoint_t *const ep, const int size, u8 *const src,
 			memcpy(data, src, size);
 	}
 
-	/* Reset endpoint if it's not running */
+	/*
+	 * Go through the endpoint's queue, so completions of other
+	 * endpoints' queued TDs that arrive meanwhile are kept.
+	 */
 	const unsigned ep_state = EC_GET(STATE, epctx);
-	if (ep_state > 1) {
-		if (xhci_reset_endpoint(ep->dev, ep))
-			return -1;
-	}
-
-	/* Enqueue transfer and ring doorbell */
-	const unsigned mps = EC_GET(MPS, epctx);
-	const unsigned dir = (ep->direction == OUT) ? TRB_DIR_OUT : TRB_DIR_IN;
-	xhci_enqueue_td(tr, ep_id, mps, size, data, dir);
-	xhci_ring_doorbell(ep);
+	if (xhci_bulk_submit(ep, size, data))
+		return -1;
 
 	/* Wait for transfer event */
-	const int ret = xhci_wait_for_transfer(xhci, ep->dev->address, ep_id);
+	const int ret = xhci_bulk_reap(ep);
 	if (ret < 0) {
 		if (ret == TIMEOUT) {
 			xhci_debug("Stopping ID %d EP %d\n",
 				   ep->dev->address, ep_id);
-			xhci_cmd_stop_endpoint(xhci, ep->dev->address, ep_id);
+			xhci_bulk_cancel(ep);
 		}
 		xhci_debug("Bulk transfer failed: %d\n"
 			   "  ep state: %d -> %d\n"
@@ -778,6 +784,106 @@ xhci_bulk(endpoint_t *const ep, const int size, u8 *const src,
 	return ret;
 }
 
+/*
+ * Queue a TD for a bulk endpoint without waiting for it. Several TDs can be
+ * queued per endpoint, as long as they fit into its transfer ring. Their
+ * completions are collected by the event handler and have to be picked up in
+ * order with xhci_bulk_reap().
+ */
+static int
+xhci_bulk_submit(endpoint_t *const ep, const int size, u8 *const data)
+{
+	xhci_t *const xhci = XHCI_INST(ep->dev->controller);
+	const int slot_id = ep->dev->address;
+	const int ep_id = xhci_ep_id(ep);
+	epctx_t *const epctx = xhci->dev[slot_id].ctx.ep[ep_id];
+	transfer_ring_t *const tr = xhci->dev[slot_id].transfer_rings[ep_id];
+	bulkq_t *bulkq = xhci->dev[slot_id].bulk_queues[ep_id];
+
+	if (!dma_coherent(data)) {
+		xhci_debug("Queued transfers need DMA coherent buffers\n");
+		return DRIVER_ERROR;
+	}
+
+	if (!bulkq) {
+		bulkq = malloc(sizeof(*bulkq));
+		if (!bulkq) {
+			xhci_debug("Out of memory\n");
+			return OUT_OF_MEMORY;
+		}
+		memset(bulkq, 0, sizeof(*bulkq));
+		xhci->dev[slot_id].bulk_queues[ep_id] = bulkq;
+	}
+
+	/* One TRB per 64KiB boundary crossed, plus the Event Data TRB */
+	const size_t off = (size_t)data & 0xffff;
+	const int trbs = (size ? (off + size + 0xffff) >> 16 : 1) + 1;
+	if (bulkq->count == MAX_QUEUED_TDS ||
+	    bulkq->trbs + trbs > TRANSFER_RING_SIZE - 1) {
+		xhci_debug("Not enough empty TRBs\n");
+		return DRIVER_ERROR;
+	}
+
+	/* Reset endpoint if it's not running */
+	if (!bulkq->count && EC_GET(STATE, epctx) > 1) {
+		if (xhci_reset_endpoint(ep->dev, ep))
+			return CONTROLLER_ERROR;
+	}
+
+	const unsigned mps = EC_GET(MPS, epctx);
+	const unsigned dir = (ep->direction == OUT) ? TRB_DIR_OUT : TRB_DIR_IN;
+	xhci_enqueue_td(tr, ep_id, mps, size, data, dir);
+	xhci_ring_doorbell(ep);
+
+	bulkq->tds[(bulkq->head + bulkq->count) % MAX_QUEUED_TDS].trbs = trbs;
+	++bulkq->count;
+	bulkq->trbs += trbs;
+	return 0;
+}
+
+/* returns amount of bytes transferred by the oldest queued TD, <0 on error */
+static int
+xhci_bulk_reap(endpoint_t *const ep)
+{
+	xhci_t *const xhci = XHCI_INST(ep->dev->controller);
+	const int slot_id = ep->dev->address;
+	const int ep_id = xhci_ep_id(ep);
+	bulkq_t *const bulkq = xhci->dev[slot_id].bulk_queues[ep_id];
+
+	if (!bulkq || !bulkq->count) {
+		xhci_debug("No transfers queued on ID %d EP %d\n",
+			   slot_id, ep_id);
+		return DRIVER_ERROR;
+	}
+
+	const int ret = xhci_wait_for_queued_transfer(xhci, bulkq);
+	if (ret < 0)
+		xhci_debug("Queued bulk transfer failed: %d\n"
+			   "  ep state: %d\n"
+			   "  usbsts:   0x%08"PRIx32"\n",
+			   ret, EC_GET(STATE, xhci->dev[slot_id].ctx.ep[ep_id]),
+			   xhci->opreg->usbsts);
+	return ret;
+}
+
+static void
+xhci_bulk_cancel(endpoint_t *const ep)
+{
+	xhci_t *const xhci = XHCI_INST(ep->dev->controller);
+	const int slot_id = ep->dev->address;
+	const int ep_id = xhci_ep_id(ep);
+	bulkq_t *const bulkq = xhci->dev[slot_id].bulk_queues[ep_id];
+
+	if (!bulkq || !bulkq->count)
+		return;
+
+	/* Stop the endpoint, so the transfer ring can be reset */
+	if (EC_GET(STATE, xhci->dev[slot_id].ctx.ep[ep_id]) == 1)
+		xhci_cmd_stop_endpoint(xhci, slot_id, ep_id);
+	xhci_reset_endpoint(ep->dev, ep);
+	memset(bulkq, 0, sizeof(*bulkq));
+}
+
 static trb_t *
 xhci_next_trb(trb_t *cur, int *const pcs)
 {
@@ -926,7 +1032,12 @@ xhci_poll_intr_queue(void *const q)
 
 	/* TODO: Reset interrupt queue if it gets halted? */
 
-	xhci_handle_events(xhci);
+	/*
+	 * Completions are dispatched to all endpoints at once, so if a poll
+	 * of another queue already found data for this one, don't bother.
+	 */
+	if (!intrq->ready)
+		xhci_handle_events(xhci);
 
 	u8 *reqdata = NULL;
 	while (!reqdata && intrq->ready) {
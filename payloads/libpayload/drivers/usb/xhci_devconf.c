@@ -465,6 +465,8 @@ xhci_destroy_dev(hci_t *const controller, const int slot_id)
 			free((void *)di->transfer_rings[i]->ring);
 		free(di->transfer_rings[i]);
 		free(di->interrupt_queues[i]);
+		free(di->bulk_queues[i]);
+		di->bulk_queues[i] = NULL;
 	}
 
 	xhci_spew("Stopped slot %d, but not disabling it yet.\n", slot_id);
@@ -87,6 +87,7 @@ xhci_handle_transfer_event(xhci_t *const xhci)
 	const int ep = TRB_GET(EP, ev);
 
 	intrq_t *intrq;
+	bulkq_t *bulkq;
 
 	if (id && id <= xhci->max_slots_en &&
 			(intrq = xhci->dev[id].interrupt_queues[ep])) {
@@ -102,6 +103,16 @@ xhci_handle_transfer_event(xhci_t *const xhci)
 		}
 	} else if (cc == CC_STOPPED || cc == CC_STOPPED_LENGTH_INVALID) {
 		/* Ignore 'Forced Stop Events' */
+	} else if (id && id <= xhci->max_slots_en &&
+			(bulkq = xhci->dev[id].bulk_queues[ep]) &&
+			bulkq->done < bulkq->count) {
+		/* TDs complete in order, so this is the oldest pending one */
+		const int td = (bulkq->head + bulkq->done) % MAX_QUEUED_TDS;
+		if (cc == CC_SUCCESS || cc == CC_SHORT_PACKET)
+			bulkq->tds[td].result = TRB_GET(EVTL, ev);
+		else
+			bulkq->tds[td].result = -cc;
+		++bulkq->done;
 	} else {
 		xhci_debug("Warning: "
 			   "Spurious transfer event for ID %d, EP %d:\n"
@@ -331,3 +342,28 @@ xhci_wait_for_transfer(xhci_t *const xhci, const int slot_id, const int ep_id)
 	xhci_update_event_dq(xhci);
 	return ret;
 }
+
+/*
+ * returns amount of bytes transferred by the oldest TD in `bulkq`,
+ * negative CC on error
+ */
+int
+xhci_wait_for_queued_transfer(xhci_t *const xhci, bulkq_t *const bulkq)
+{
+	/* 3s, same as for synchronous transfers */
+	unsigned long timeout_us = 3 * 1000 * 1000;
+	while (!bulkq->done && xhci_wait_for_event(&xhci->er, &timeout_us))
+		xhci_handle_event(xhci);
+	xhci_update_event_dq(xhci);
+	if (!bulkq->done) {
+		xhci_debug("Warning: Timed out waiting for queued transfer.\n");
+		return TIMEOUT;
+	}
+
+	const int ret = bulkq->tds[bulkq->head].result;
+	bulkq->trbs -= bulkq->tds[bulkq->head].trbs;
+	bulkq->head = (bulkq->head + 1) % MAX_QUEUED_TDS;
+	--bulkq->count;
+	--bulkq->done;
+	return ret;
+}
@@ -308,10 +308,24 @@ typedef struct intrq {
 	endpoint_t *ep;
 } intrq_t;
 
+/* Every TD takes at least two TRBs (data and event data). */
+#define MAX_QUEUED_TDS (TRANSFER_RING_SIZE / 2)
+typedef struct bulkq {
+	int head;	/* Index of the oldest queued TD */
+	int count;	/* Number of queued TDs that weren't reaped yet */
+	int done;	/* Number of those the controller reported back */
+	int trbs;	/* Number of TRBs used by queued TDs */
+	struct {
+		int trbs;
+		int result;	/* Bytes transferred or negative CC */
+	} tds[MAX_QUEUED_TDS];
+} bulkq_t;
+
 typedef struct devinfo {
 	devctx_t ctx;
 	transfer_ring_t *transfer_rings[NUM_EPS];
 	intrq_t *interrupt_queues[NUM_EPS];
+	bulkq_t *bulk_queues[NUM_EPS];
 } devinfo_t;
 
 typedef struct erst_entry {
@@ -500,6 +514,7 @@ void xhci_handle_events(xhci_t *);
 int xhci_wait_for_command_aborted(xhci_t *, const trb_t *);
 int xhci_wait_for_command_done(xhci_t *, const trb_t *, int clear_event);
 int xhci_wait_for_transfer(xhci_t *, const int slot_id, const int ep_id);
+int xhci_wait_for_queued_transfer(xhci_t *, bulkq_t *);
 
 void xhci_clear_trb(trb_t *, int pcs);
 
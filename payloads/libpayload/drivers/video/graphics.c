@@ -122,16 +122,21 @@ static inline uint32_t calculate_color(const struct rgb_color *rgb)
  * Plot a pixel in a framebuffer. This is called from tight loops. Keep it slim
  * and do the validation at callers' site.
  */
-static inline void set_pixel(struct vector *coord, uint32_t color)
+static inline void set_pixel_at(uint8_t *base, int bpl,
+				struct vector *coord, uint32_t color)
 {
 	const int bpp = fbinfo->bits_per_pixel;
-	const int bpl = fbinfo->bytes_per_line;
 	int i;
-	uint8_t * const pixel = fbaddr + coord->y * bpl + coord->x * bpp / 8;
+	uint8_t * const pixel = base + coord->y * bpl + coord->x * bpp / 8;
 	for (i = 0; i < bpp / 8; i++)
 		pixel[i] = (color >> (i * 8));
 }
 
+static inline void set_pixel(struct vector *coord, uint32_t color)
+{
+	set_pixel_at(fbaddr, fbinfo->bytes_per_line, coord, color);
+}
+
 /*
  * Initializes the library. Automatically called by APIs. It sets up
  * the canvas and the framebuffer.
@@ -263,7 +268,8 @@ static uint32_t bli(uint32_t q00, uint32_t q10, uint32_t q01, uint32_t q11,
 	return p;
 }
 
-static int draw_bitmap_v3(const struct vector *top_left,
+static int draw_bitmap_v3(uint8_t *base, int bpl,
+			  const struct vector *top_left,
 			  const struct scale *scale,
 			  const struct vector *dim,
 			  const struct vector *dim_org,
@@ -361,7 +367,7 @@ static int draw_bitmap_v3(const struct vector *top_left,
 					    pal[c01].blue, pal[c11].blue,
 					    &tx, &ty),
 			};
-			set_pixel(&p, calculate_color(&rgb));
+			set_pixel_at(base, bpl, &p, calculate_color(&rgb));
 		}
 	}
 
@@ -551,6 +557,191 @@ static int check_boundary(const struct vector *top_left,
 	return CBGFX_SUCCESS;
 }
 
+#if IS_ENABLED(CONFIG_LP_CBGFX_BITMAP_CACHE)
+/*
+ * Bitmaps which have already been scaled and converted to the framebuffer
+ * format. Entries are keyed by the address and size of the bitmap file, the
+ * projected dimension and the framebuffer format, and are linked from the most
+ * recently to the least recently drawn one. The parsed header is compared as
+ * well, which is cheap and catches most other bitmaps loaded to the same
+ * address. Callers reusing a buffer for another bitmap have to flush the cache.
+ */
+struct bitmap_cache_entry {
+	struct bitmap_cache_entry *prev;
+	struct bitmap_cache_entry *next;
+	const void *bitmap;
+	size_t bitmap_size;
+	struct bitmap_header_v3 header;
+	uint64_t fb_format;
+	struct vector dim;
+	size_t stride;
+	size_t alloc_size;
+	uint8_t pixels[0];
+};
+
+static struct bitmap_cache_entry *cache_head;
+static struct bitmap_cache_entry *cache_tail;
+static struct cbgfx_bitmap_cache_stats cache_stats = {
+	.budget = CONFIG_LP_CBGFX_BITMAP_CACHE_SIZE * KiB,
+};
+
+static uint64_t framebuffer_format(void)
+{
+	return (uint64_t)fbinfo->bits_per_pixel << 48 |
+	       (uint64_t)fbinfo->red_mask_pos << 40 |
+	       (uint64_t)fbinfo->red_mask_size << 32 |
+	       (uint32_t)fbinfo->green_mask_pos << 24 |
+	       fbinfo->green_mask_size << 16 |
+	       fbinfo->blue_mask_pos << 8 |
+	       fbinfo->blue_mask_size;
+}
+
+static void bitmap_cache_unlink(struct bitmap_cache_entry *e)
+{
+	if (e->prev)
+		e->prev->next = e->next;
+	else
+		cache_head = e->next;
+	if (e->next)
+		e->next->prev = e->prev;
+	else
+		cache_tail = e->prev;
+}
+
+static void bitmap_cache_push(struct bitmap_cache_entry *e)
+{
+	e->prev = NULL;
+	e->next = cache_head;
+	if (cache_head)
+		cache_head->prev = e;
+	else
+		cache_tail = e;
+	cache_head = e;
+}
+
+static void bitmap_cache_evict(struct bitmap_cache_entry *e)
+{
+	bitmap_cache_unlink(e);
+	cache_stats.used -= e->alloc_size;
+	cache_stats.entries--;
+	free(e);
+}
+
+static void bitmap_cache_blit(const struct bitmap_cache_entry *e,
+			      const struct vector *top_left)
+{
+	const int bpl = fbinfo->bytes_per_line;
+	uint8_t *dst = fbaddr + top_left->y * bpl +
+		       top_left->x * fbinfo->bits_per_pixel / 8;
+	const uint8_t *src = e->pixels;
+	int y;
+
+	for (y = 0; y < e->dim.height; y++, dst += bpl, src += e->stride)
+		memcpy(dst, src, e->stride);
+}
+
+static int draw_bitmap_cached(const void *bitmap, size_t size,
+			      const struct vector *top_left,
+			      const struct scale *scale,
+			      const struct vector *dim,
+			      const struct vector *dim_org,
+			      const struct bitmap_header_v3 *header,
+			      const struct bitmap_palette_element_v3 *pal,
+			      const uint8_t *pixel_array)
+{
+	const uint64_t fb_format = framebuffer_format();
+	const size_t stride = dim->width * fbinfo->bits_per_pixel / 8;
+	const struct vector origin = vzero;
+	struct bitmap_cache_entry *e;
+	size_t alloc_size;
+	int rv;
+
+	for (e = cache_head; e; e = e->next) {
+		if (e->bitmap != bitmap || e->bitmap_size != size ||
+		    e->fb_format != fb_format || e->dim.width != dim->width ||
+		    e->dim.height != dim->height ||
+		    memcmp(&e->header, header, sizeof(*header)))
+			continue;
+		cache_stats.hits++;
+		bitmap_cache_unlink(e);
+		bitmap_cache_push(e);
+		bitmap_cache_blit(e, top_left);
+		return CBGFX_SUCCESS;
+	}
+	cache_stats.misses++;
+
+	alloc_size = sizeof(*e) + stride * dim->height;
+	if (alloc_size > cache_stats.budget)
+		return draw_bitmap_v3(fbaddr, fbinfo->bytes_per_line, top_left,
+				      scale, dim, dim_org, header, pal,
+				      pixel_array);
+
+	while (cache_tail &&
+	       cache_stats.used + alloc_size > cache_stats.budget) {
+		bitmap_cache_evict(cache_tail);
+		cache_stats.evictions++;
+	}
+
+	e = malloc(alloc_size);
+	if (!e)
+		return draw_bitmap_v3(fbaddr, fbinfo->bytes_per_line, top_left,
+				      scale, dim, dim_org, header, pal,
+				      pixel_array);
+
+	rv = draw_bitmap_v3(e->pixels, stride, &origin, scale, dim, dim_org,
+			    header, pal, pixel_array);
+	if (rv) {
+		free(e);
+		return rv;
+	}
+
+	e->bitmap = bitmap;
+	e->bitmap_size = size;
+	e->header = *header;
+	e->fb_format = fb_format;
+	e->dim = *dim;
+	e->stride = stride;
+	e->alloc_size = alloc_size;
+	bitmap_cache_push(e);
+	cache_stats.used += alloc_size;
+	cache_stats.entries++;
+
+	bitmap_cache_blit(e, top_left);
+	return CBGFX_SUCCESS;
+}
+#else
+static int draw_bitmap_cached(const void *bitmap, size_t size,
+			      const struct vector *top_left,
+			      const struct scale *scale,
+			      const struct vector *dim,
+			      const struct vector *dim_org,
+			      const struct bitmap_header_v3 *header,
+			      const struct bitmap_palette_element_v3 *pal,
+			      const uint8_t *pixel_array)
+{
+	return draw_bitmap_v3(fbaddr, fbinfo->bytes_per_line, top_left, scale,
+			      dim, dim_org, header, pal, pixel_array);
+}
+#endif
+
+int get_bitmap_cache_stats(struct cbgfx_bitmap_cache_stats *stats)
+{
+#if IS_ENABLED(CONFIG_LP_CBGFX_BITMAP_CACHE)
+	*stats = cache_stats;
+#else
+	memset(stats, 0, sizeof(*stats));
+#endif
+	return CBGFX_SUCCESS;
+}
+
+void flush_bitmap_cache(void)
+{
+#if IS_ENABLED(CONFIG_LP_CBGFX_BITMAP_CACHE)
+	while (cache_head)
+		bitmap_cache_evict(cache_head);
+#endif
+}
+
 int draw_bitmap(const void *bitmap, size_t size,
 		const struct scale *pos_rel, uint8_t pivot,
 		const struct scale *dim_rel)
@@ -593,8 +784,8 @@ int draw_bitmap(const void *bitmap, size_t size,
 		return rv;
 	}
 
-	return draw_bitmap_v3(&top_left, &scale, &dim, &dim_org,
-			      &header, palette, pixel_array);
+	return draw_bitmap_cached(bitmap, size, &top_left, &scale, &dim,
+				  &dim_org, &header, palette, pixel_array);
 }
 
 int draw_bitmap_direct(const void *bitmap, size_t size,
@@ -628,8 +819,8 @@ int draw_bitmap_direct(const void *bitmap, size_t size,
 		return rv;
 	}
 
-	return draw_bitmap_v3(top_left, &scale, &dim, &dim,
-			      &header, palette, pixel_array);
+	return draw_bitmap_cached(bitmap, size, top_left, &scale, &dim, &dim,
+				  &header, palette, pixel_array);
 }
 
 int get_bitmap_dimension(const void *bitmap, size_t sz, struct scale *dim_rel)
@@ -184,3 +184,34 @@ int draw_bitmap_direct(const void *bitmap, size_t size,
  * in the original size are returned.
  */
 int get_bitmap_dimension(const void *bitmap, size_t sz, struct scale *dim_rel);
+
+/*
+ * Statistics of the bitmap cache (CONFIG_LP_CBGFX_BITMAP_CACHE). Sizes are in
+ * bytes.
+ */
+struct cbgfx_bitmap_cache_stats {
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t evictions;
+	uint32_t entries;
+	size_t used;
+	size_t budget;
+};
+
+/**
+ * Get hit/miss counters and memory usage of the bitmap cache
+ *
+ * @param[out] stats	Statistics of the cache. All zero if the cache is
+ *			disabled.
+ *
+ * @return CBGFX_* error codes
+ */
+int get_bitmap_cache_stats(struct cbgfx_bitmap_cache_stats *stats);
+
+/**
+ * Drop all bitmaps from the bitmap cache and free their memory
+ *
+ * Cached bitmaps are looked up by their address. This has to be called before
+ * a buffer which has been drawn from is freed or loaded with another bitmap.
+ */
+void flush_bitmap_cache(void);
@@ -39,6 +39,7 @@
 enum {
 	ATA_READ_DMA			= 0xc8,
 	ATA_READ_DMA_EXT		= 0x25,
+	ATA_READ_FPDMA_QUEUED		= 0x60,
 	ATA_IDENTIFY_DEVICE		= 0xec,
 	ATA_PACKET			= 0xa0,
 	ATA_IDENTIFY_PACKET_DEVICE	= 0xa1,
@@ -46,6 +47,8 @@ enum {
 
 /* 16-bit-word indices into id structure from ATA_IDENTIFY_DEVICE */
 enum {
+	ATA_ID_QUEUE_DEPTH		=  75,
+	ATA_ID_SATA_CAPS		=  76,
 	ATA_CMDS_AND_FEATURE_SETS	=  82,
 	ATA_ID_SECTOR_SIZE		= 106,
 	ATA_ID_LOGICAL_SECTOR_SIZE	= 117,
@@ -59,11 +62,17 @@ typedef struct ata_dev {
 
 	int (*identify)(struct ata_dev *, u8 *buf);
 	ssize_t (*read_sectors)(struct ata_dev *, lba_t start, size_t count, u8 *buf);
+	/* Optional asynchronous reads, submit returns a tag for complete. */
+	int (*submit_read_sectors)(struct ata_dev *, lba_t start, size_t count, u8 *buf);
+	ssize_t (*complete_read)(struct ata_dev *, int tag);
 
 	u8 read_cmd;
 	u8 identify_cmd;
 	size_t sector_size;
 	size_t sector_size_shift;
+	/* Set by the controller driver to the number of commands it can
+	   queue, reduced to what the drive supports on attachment. */
+	size_t queue_depth;
 
 	void (*detach_device)(struct ata_dev *);
 } ata_dev_t;
@@ -64,6 +64,9 @@ typedef struct storage_dev {
 	storage_poll_t (*poll)(struct storage_dev *);
 	ssize_t (*read_blocks512)(struct storage_dev *, lba_t start, size_t count, unsigned char *buf);
 	ssize_t (*write_blocks512)(struct storage_dev *, lba_t start, size_t count, const unsigned char *buf);
+	/* Optional, see storage_submit_read_blocks512(). */
+	int (*submit_read512)(struct storage_dev *, lba_t start, size_t count, unsigned char *buf);
+	ssize_t (*complete_read512)(struct storage_dev *, int tag);
 
 	void (*detach_device)(struct storage_dev *);
 } storage_dev_t;
@@ -74,5 +77,7 @@ int storage_attach_device(storage_dev_t *dev);
 
 storage_poll_t storage_probe(size_t dev_num);
 ssize_t storage_read_blocks512(size_t dev_num, lba_t start, size_t count, unsigned char *buf);
+int storage_submit_read_blocks512(size_t dev_num, lba_t start, size_t count, unsigned char *buf);
+ssize_t storage_complete_read_blocks512(size_t dev_num, int tag);
 
 #endif
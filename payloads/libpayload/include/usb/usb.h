@@ -233,6 +233,18 @@ struct usbdev_hc {
 	void (*shutdown) (hci_t *controller);
 
 	int (*bulk) (endpoint_t *ep, int size, u8 *data, int finalize);
+	/* bulk_submit():	Queue a bulk transfer without waiting for its
+				completion, returns 0 on success. Optional.
+				data has to be DMA coherent and stay valid
+				until the transfer was reaped. */
+	int (*bulk_submit) (endpoint_t *ep, int size, u8 *data);
+	/* bulk_reap():		Wait for the oldest transfer queued on ep.
+				Returns the amount of bytes transferred or a
+				negative error code. */
+	int (*bulk_reap) (endpoint_t *ep);
+	/* bulk_cancel():	Drop all transfers queued on ep, leaving the
+				endpoint ready for new transfers. */
+	void (*bulk_cancel) (endpoint_t *ep);
 	int (*control) (usbdev_t *dev, direction_t pid, int dr_length,
 			void *devreq, int data_length, u8 *data);
 	void* (*create_intr_queue) (endpoint_t *ep, int reqsize, int reqcount, int reqtiming);
@@ -45,18 +45,42 @@ void acpigen_write_len_f(void)
 	acpigen_emit_byte(0);
 }
 
+/*
+ * Fill in the PkgLength reserved by acpigen_write_len_f with the shortest
+ * encoding that fits and move the package contents down over the unused
+ * bytes. Pointers into the package contents are no longer valid afterwards.
+ */
 void acpigen_pop_len(void)
 {
-	int len;
+	int len, size;
 	ASSERT(ltop > 0)
 	char *p = len_stack[--ltop];
-	len = gencurrent - p;
+	/* Size of the package contents after the PkgLength */
+	len = gencurrent - p - 3;
+
+	if (len + 1 <= 0x3f)
+		size = 1;
+	else if (len + 2 <= 0xfff)
+		size = 2;
+	else
+		size = 3;
+	len += size;
 	ASSERT(len <= ACPIGEN_MAXLEN)
-	/* generate store length for 0xfffff max */
-	p[0] = (0x80 | (len & 0xf));
-	p[1] = (len >> 4 & 0xff);
-	p[2] = (len >> 12 & 0xff);
 
+	if (size == 1) {
+		p[0] = len;
+	} else {
+		/* Bits 7-6 are the number of bytes that follow */
+		p[0] = ((size - 1) << 6) | (len & 0xf);
+		p[1] = (len >> 4 & 0xff);
+		if (size == 3)
+			p[2] = (len >> 12 & 0xff);
+	}
+
+	if (size < 3) {
+		memmove(p + size, p + 3, gencurrent - (p + 3));
+		gencurrent -= 3 - size;
+	}
 }
 
 void acpigen_set_current(char *curr)
@@ -82,16 +106,18 @@ void acpigen_emit_ext_op(uint8_t op)
 
 void acpigen_emit_word(unsigned int data)
 {
-	acpigen_emit_byte(data & 0xff);
-	acpigen_emit_byte((data >> 8) & 0xff);
+	gencurrent[0] = data & 0xff;
+	gencurrent[1] = (data >> 8) & 0xff;
+	gencurrent += 2;
 }
 
 void acpigen_emit_dword(unsigned int data)
 {
-	acpigen_emit_byte(data & 0xff);
-	acpigen_emit_byte((data >> 8) & 0xff);
-	acpigen_emit_byte((data >> 16) & 0xff);
-	acpigen_emit_byte((data >> 24) & 0xff);
+	gencurrent[0] = data & 0xff;
+	gencurrent[1] = (data >> 8) & 0xff;
+	gencurrent[2] = (data >> 16) & 0xff;
+	gencurrent[3] = (data >> 24) & 0xff;
+	gencurrent += 4;
 }
 
 char *acpigen_write_package(int nr_el)
@@ -204,9 +230,8 @@ void acpigen_write_name_string(const char *name, const char *string)
 
 void acpigen_emit_stream(const char *data, int size)
 {
-	int i;
-	for (i = 0; i < size; i++)
-		acpigen_emit_byte(data[i]);
+	memcpy(gencurrent, data, size);
+	gencurrent += size;
 }
 
 void acpigen_emit_string(const char *string)
@@ -31,4 +31,16 @@ size_t ulz4fn(const void *src, size_t srcn, void *dst, size_t dstn);
 /* Same as ulz4fn() but does not perform any bounds checks. */
 size_t ulz4f(const void *src, void *dst);
 
+/* Bytes of scratch memory lz4f_compress() needs. */
+#define LZ4F_COMPRESS_SCRATCH_SIZE (16 * 1024)
+
+/* Compresses srcn bytes from src into an LZ4F image that ulz4fn() can
+ * decompress, using scratch as working memory. If dst is NULL, only the size
+ * of the image is calculated. The image and its size are the same for the same
+ * input, so the size can be used to allocate the exact output buffer.
+ * Returns the size of the image, or 0 if it doesn't fit into dstn bytes.
+ */
+size_t lz4f_compress(const void *src, size_t srcn, void *dst, size_t dstn,
+		     void *scratch);
+
 #endif	/* _COMMONLIB_COMPRESSION_H_ */
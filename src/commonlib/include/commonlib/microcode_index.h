@@ -0,0 +1,47 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef __COMMONLIB_MICROCODE_INDEX_H__
+#define __COMMONLIB_MICROCODE_INDEX_H__
+
+#include <stdint.h>
+
+/*
+ * Index of the Intel microcode updates in cpu_microcode_blob.bin, added to
+ * CBFS by cbfstool add-microcode-index. It lists the processor signature and
+ * flags of every update's header in the order of the blob, so looking up an
+ * update only has to read the index and the update itself. The index ends at
+ * the first header that doesn't look like an Intel update, like padding at
+ * the end of the blob. All fields are little endian.
+ */
+
+#define MICROCODE_INDEX_CBFS_FILE	"cpu_microcode_index.bin"
+#define MICROCODE_INDEX_MAGIC		0x58444955	/* "UIDX" */
+
+struct microcode_index_header {
+	uint32_t magic;
+	/* Size of the indexed blob, to notice the blob being replaced. */
+	uint32_t blob_size;
+	uint32_t num_entries;
+	/* Offset the indexed updates end at. */
+	uint32_t indexed_size;
+} __attribute__((packed));
+
+struct microcode_index_entry {
+	uint32_t sig;		/* Processor Signature */
+	uint32_t pf;		/* Processor Flags */
+	uint32_t offset;	/* Offset of the update in the blob */
+	uint32_t size;		/* Total size of the update */
+} __attribute__((packed));
+
+#endif /* __COMMONLIB_MICROCODE_INDEX_H__ */
@@ -0,0 +1,39 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef __MP_TIMING_SERIALIZED_H__
+#define __MP_TIMING_SERIALIZED_H__
+
+#include <stdint.h>
+
+/*
+ * With COLLECT_TIMESTAMPS, mp_init_with_smm() stores when each CPU got
+ * through the initialization in CBMEM_ID_MP_TIMING. All times are in
+ * timestamp ticks. Times of APs that never checked in are 0.
+ */
+struct mp_cpu_timing {
+	uint32_t apic_id;
+	uint32_t reserved;
+	uint64_t entry;		/* AP reached ap_init() */
+	uint64_t init_done;	/* mp_initialize_cpu() returned */
+} __attribute__((packed));
+
+struct mp_timing {
+	uint64_t sipi;		/* BSP started sending INIT/SIPI */
+	uint64_t done;		/* BSP saw all CPUs finish the flight plan */
+	uint32_t tick_freq_mhz;
+	uint32_t num_cpus;
+	struct mp_cpu_timing cpus[0];
+} __attribute__((packed));
+
+#endif /* __MP_TIMING_SERIALIZED_H__ */
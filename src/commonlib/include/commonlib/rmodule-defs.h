@@ -19,7 +19,17 @@
 #include <stddef.h>
 
 #define RMODULE_MAGIC 0xf8fe
+/* Relocations are an array of pointer sized link addresses. */
 #define RMODULE_VERSION_1 1
+/*
+ * Relocations are a byte stream of runs of consecutive pointer sized slots,
+ * sorted by address and all within the payload. Every run starts with a
+ * ULEB128 number holding the distance in bytes from the end of the previous
+ * run (from link address 0 for the first run) shifted left by one. If its
+ * low bit is set, a second ULEB128 number holds the number of slots in the
+ * run minus 2, otherwise the run is a single slot.
+ */
+#define RMODULE_VERSION_2 2
 
 /* All fields with '_offset' in the name are byte offsets into the flat blob.
  * The linker and the linker script takes are of assigning the values.  */
@@ -56,4 +66,49 @@ struct rmodule_header {
 	uint32_t padding[4];
 } __attribute__ ((packed));
 
+/* Decode a ULEB128 number. Returns 0 on success, -1 if it's truncated or
+ * doesn't fit into a size_t. */
+static inline int rmodule_get_uleb128(const uint8_t **p, const uint8_t *end,
+				      size_t *val)
+{
+	unsigned int shift = 0;
+
+	/* Most numbers fit into a single byte. */
+	if (*p < end && !(**p & 0x80)) {
+		*val = *(*p)++;
+		return 0;
+	}
+
+	*val = 0;
+	while (*p < end && shift < 8 * sizeof(*val)) {
+		const uint8_t b = *(*p)++;
+
+		*val |= (size_t)(b & 0x7f) << shift;
+		if (!(b & 0x80))
+			return 0;
+		shift += 7;
+	}
+
+	return -1;
+}
+
+/* Decode the next run of a RMODULE_VERSION_2 relocation stream. Returns 0
+ * on success, -1 on a malformed stream. */
+static inline int rmodule_get_reloc_run(const uint8_t **p, const uint8_t *end,
+					size_t *distance, size_t *count)
+{
+	if (rmodule_get_uleb128(p, end, distance))
+		return -1;
+
+	*count = 1;
+	if (*distance & 1) {
+		if (rmodule_get_uleb128(p, end, count))
+			return -1;
+		*count += 2;
+	}
+	*distance >>= 1;
+
+	return 0;
+}
+
 #endif /* RMODULE_DEFS_H */
@@ -55,6 +55,9 @@ enum timestamp_id {
 	TS_END_COPYDTB = 22,
 	TS_START_COPYINITRD = 23,
 	TS_END_COPYINITRD = 24,
+	TS_START_STAGE_CACHE_LOAD = 25,
+	TS_STAGE_CACHE_VERIFIED = 26,
+	TS_END_STAGE_CACHE_LOAD = 27,
 	TS_DEVICE_ENUMERATE = 30,
 	TS_DEVICE_CONFIGURE = 40,
 	TS_DEVICE_ENABLE = 50,
@@ -147,6 +150,9 @@ static const struct timestamp_id_to_name {
 	{ TS_END_COPYDTB,	"finished loading dtb" },
 	{ TS_START_COPYINITRD,	"starting to load initrd" },
 	{ TS_END_COPYINITRD,	"finished loading initrd" },
+	{ TS_START_STAGE_CACHE_LOAD, "starting to load stage from cache" },
+	{ TS_STAGE_CACHE_VERIFIED, "finished verifying cached stage" },
+	{ TS_END_STAGE_CACHE_LOAD, "finished loading stage from cache" },
 	{ TS_DEVICE_ENUMERATE,	"device enumeration" },
 	{ TS_DEVICE_CONFIGURE,	"device configuration" },
 	{ TS_DEVICE_ENABLE,	"device enable" },
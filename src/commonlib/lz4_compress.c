@@ -0,0 +1,193 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Small greedy LZ4 compressor producing the subset of the LZ4 frame format
+ * that ulz4fn() understands: a single frame of independent blocks without
+ * checksums. It trades ratio for speed and a fixed, small working set so it
+ * can run in any stage that has a few KiB of memory to spare.
+ */
+
+#include <commonlib/compression.h>
+#include <commonlib/endian.h>
+#include <commonlib/helpers.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LZ4F_MAGICNUMBER	0x184D2204
+/* Version 1, independent blocks, no checksums, no content size. */
+#define LZ4F_FLG		0x60
+/* 4MiB maximum block size. */
+#define LZ4F_BD			0x70
+#define LZ4F_BLOCK_SIZE		(4 * MiB)
+#define LZ4F_UNCOMPRESSED	(1U << 31)
+
+#define LZ4_MINMATCH		4
+/* The last match has to start 12 bytes before the end of a block ... */
+#define LZ4_MFLIMIT		12
+/* ... and the last 5 bytes are always literals. */
+#define LZ4_LASTLITERALS	5
+#define LZ4_MAX_DISTANCE	0xffff
+#define LZ4_HASH_LOG		12
+
+_Static_assert((1 << LZ4_HASH_LOG) * sizeof(uint32_t) ==
+	       LZ4F_COMPRESS_SCRATCH_SIZE, "Scratch size doesn't match table");
+
+struct lz4_out {
+	uint8_t *dst;	/* NULL to only count the output. */
+	size_t size;
+	size_t pos;
+};
+
+static void lz4_put(struct lz4_out *o, const void *src, size_t n)
+{
+	if (o->dst != NULL && o->pos + n <= o->size)
+		memcpy(o->dst + o->pos, src, n);
+	o->pos += n;
+}
+
+static void lz4_put_byte(struct lz4_out *o, uint8_t b)
+{
+	lz4_put(o, &b, 1);
+}
+
+static void lz4_put_le32_at(struct lz4_out *o, size_t pos, uint32_t val)
+{
+	if (o->dst != NULL && pos + sizeof(val) <= o->size)
+		write_le32(o->dst + pos, val);
+}
+
+static void lz4_put_length(struct lz4_out *o, size_t len)
+{
+	for (; len >= 255; len -= 255)
+		lz4_put_byte(o, 255);
+	lz4_put_byte(o, len);
+}
+
+static void lz4_put_sequence(struct lz4_out *o, const uint8_t *literals,
+			     size_t literal_len, size_t offset, size_t match_len)
+{
+	uint8_t token = MIN(literal_len, 15) << 4;
+
+	/* The last sequence of a block has no match. */
+	if (offset != 0)
+		token |= MIN(match_len - LZ4_MINMATCH, 15);
+
+	lz4_put_byte(o, token);
+	if (literal_len >= 15)
+		lz4_put_length(o, literal_len - 15);
+	lz4_put(o, literals, literal_len);
+
+	if (offset == 0)
+		return;
+
+	lz4_put_byte(o, offset & 0xff);
+	lz4_put_byte(o, offset >> 8);
+	if (match_len - LZ4_MINMATCH >= 15)
+		lz4_put_length(o, match_len - LZ4_MINMATCH - 15);
+}
+
+static inline uint32_t lz4_hash(uint32_t seq)
+{
+	return (seq * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+static void lz4_compress_block(struct lz4_out *o, const uint8_t *src,
+			       size_t len, uint32_t *table)
+{
+	const uint8_t *const end = src + len;
+	const uint8_t *const match_limit = end - LZ4_LASTLITERALS;
+	const uint8_t *ip = src;
+	const uint8_t *anchor = src;
+
+	memset(table, 0, LZ4F_COMPRESS_SCRATCH_SIZE);
+
+	while (len > LZ4_MFLIMIT && ip <= end - LZ4_MFLIMIT) {
+		const uint32_t seq = read_le32(ip);
+		const uint32_t h = lz4_hash(seq);
+		const uint8_t *ref = src + table[h];
+		size_t match_len;
+
+		table[h] = ip - src;
+
+		if (ref >= ip || ip - ref > LZ4_MAX_DISTANCE ||
+		    read_le32(ref) != seq) {
+			/* Skip faster through data that doesn't compress. */
+			ip += 1 + ((ip - anchor) >> 6);
+			continue;
+		}
+
+		while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+			ip--;
+			ref--;
+		}
+
+		match_len = LZ4_MINMATCH;
+		while (ip + match_len < match_limit &&
+		       ip[match_len] == ref[match_len])
+			match_len++;
+
+		lz4_put_sequence(o, anchor, ip - anchor, ip - ref, match_len);
+		ip += match_len;
+		anchor = ip;
+	}
+
+	lz4_put_sequence(o, anchor, end - anchor, 0, 0);
+}
+
+size_t lz4f_compress(const void *src, size_t srcn, void *dst, size_t dstn,
+		     void *scratch)
+{
+	struct lz4_out o = { .dst = dst, .size = dstn };
+	const uint8_t *in = src;
+	uint8_t header[7];
+
+	write_le32(header, LZ4F_MAGICNUMBER);
+	header[4] = LZ4F_FLG;
+	header[5] = LZ4F_BD;
+	/* The header checksum isn't checked by ulz4fn(). */
+	header[6] = 0;
+	lz4_put(&o, header, sizeof(header));
+
+	while (srcn != 0) {
+		const size_t len = MIN(srcn, LZ4F_BLOCK_SIZE);
+		const size_t block = o.pos;
+		size_t size;
+
+		o.pos += sizeof(uint32_t);
+		lz4_compress_block(&o, in, len, scratch);
+		size = o.pos - block - sizeof(uint32_t);
+
+		/* Store blocks that didn't shrink as they are. Both this
+		 * decision and the output are the same whether the output is
+		 * only counted or not. */
+		if (size >= len) {
+			o.pos = block + sizeof(uint32_t);
+			lz4_put(&o, in, len);
+			size = len | LZ4F_UNCOMPRESSED;
+		}
+		lz4_put_le32_at(&o, block, size);
+
+		in += len;
+		srcn -= len;
+	}
+
+	/* End mark. */
+	lz4_put_le32_at(&o, o.pos, 0);
+	o.pos += sizeof(uint32_t);
+
+	if (dst != NULL && o.pos > dstn)
+		return 0;
+
+	return o.pos;
+}
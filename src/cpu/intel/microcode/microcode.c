@@ -24,6 +24,7 @@
 #else
 #include <arch/cbfs.h>
 #endif
+#include <commonlib/microcode_index.h>
 #include <cpu/cpu.h>
 #include <cpu/x86/msr.h>
 #include <cpu/intel/microcode.h>
@@ -32,6 +33,21 @@
 #if !defined(__PRE_RAM__)
 #include <smp/spinlock.h>
 DECLARE_SPIN_LOCK(microcode_lock)
+
+/* The blob and index mapped by the first lookup, and the last update found.
+ * All CPUs of a system usually share it, so the APs don't have to look it up
+ * again. Protected by microcode_lock. */
+static struct {
+	int mapped;
+	const void *blob;
+	size_t blob_len;
+	const void *index;
+	size_t index_len;
+	int valid;
+	u32 sig;
+	u32 pf;
+	const void *patch;
+} microcode_cache;
 #endif
 
 struct microcode {
@@ -112,12 +128,95 @@ void intel_microcode_load_unlocked(const void *microcode_patch)
 #endif
 }
 
+#if !defined(__ROMCC__)
+/* Map the blob and its index. In ramstage only the first call walks CBFS. */
+static const void *microcode_map(size_t *microcode_len, const void **index,
+				 size_t *index_len)
+{
+	const void *blob;
+
+#if !defined(__PRE_RAM__)
+	spin_lock(&microcode_lock);
+	if (microcode_cache.mapped) {
+		*microcode_len = microcode_cache.blob_len;
+		*index = microcode_cache.index;
+		*index_len = microcode_cache.index_len;
+		blob = microcode_cache.blob;
+		spin_unlock(&microcode_lock);
+		return blob;
+	}
+	spin_unlock(&microcode_lock);
+#endif
+
+	blob = cbfs_boot_map_with_leak(MICROCODE_CBFS_FILE,
+				       CBFS_TYPE_MICROCODE, microcode_len);
+	if (blob == NULL)
+		return NULL;
+
+	*index = NULL;
+	*index_len = 0;
+	if (IS_ENABLED(CONFIG_CPU_MICROCODE_CBFS_INDEX))
+		*index = cbfs_boot_map_with_leak(MICROCODE_INDEX_CBFS_FILE,
+						 CBFS_TYPE_RAW, index_len);
+
+#if !defined(__PRE_RAM__)
+	spin_lock(&microcode_lock);
+	microcode_cache.blob = blob;
+	microcode_cache.blob_len = *microcode_len;
+	microcode_cache.index = *index;
+	microcode_cache.index_len = *index_len;
+	microcode_cache.mapped = 1;
+	spin_unlock(&microcode_lock);
+#endif
+
+	return blob;
+}
+
+/*
+ * Returns the offset in the blob to start looking for the update for sig and
+ * pf at: the offset of the first matching update listed in the index, the
+ * offset the index ends at if it lists none, or 0 if there is no usable index.
+ */
+static size_t microcode_index_lookup(const struct microcode_index_header *hdr,
+				     size_t index_len, size_t microcode_len,
+				     u32 sig, u32 pf)
+{
+	const struct microcode_index_entry *entry;
+	u32 i;
+
+	if (hdr == NULL)
+		return 0;
+
+	if (index_len < sizeof(*hdr) || hdr->magic != MICROCODE_INDEX_MAGIC ||
+	    hdr->blob_size != microcode_len ||
+	    hdr->indexed_size > microcode_len ||
+	    hdr->num_entries > (index_len - sizeof(*hdr)) / sizeof(*entry))
+		return 0;
+
+	entry = (const void *)(hdr + 1);
+	for (i = 0; i < hdr->num_entries; i++, entry++) {
+		if (entry->offset > microcode_len)
+			return 0;
+		if ((entry->sig == sig) && (entry->pf & pf))
+			return entry->offset;
+	}
+
+	return hdr->indexed_size;
+}
+#endif
+
 const void *intel_microcode_find(void)
 {
 	const struct microcode *ucode_updates;
+	/* ROMCC doesn't like NULL. */
+	const struct microcode *found = (void *)0;
 	size_t microcode_len;
 	u32 eax;
 	u32 pf, rev, sig, update_size;
+#if !defined(__ROMCC__)
+	const void *index;
+	size_t index_len, offset;
+#endif
 	unsigned int x86_model, x86_family;
 	msr_t msr;
 
@@ -131,9 +230,7 @@ const void *intel_microcode_find(void)
 	ucode_updates = CBFS_SUBHEADER(microcode_file);
 	microcode_len = ntohl(microcode_file->len);
 #else
-	ucode_updates = cbfs_boot_map_with_leak(MICROCODE_CBFS_FILE,
-						CBFS_TYPE_MICROCODE,
-						&microcode_len);
+	ucode_updates = microcode_map(&microcode_len, &index, &index_len);
 	if (ucode_updates == NULL)
 		return NULL;
 #endif
@@ -162,6 +259,26 @@ const void *intel_microcode_find(void)
 			sig, pf, rev);
 #endif
 
+#if !defined(__ROMCC__) && !defined(__PRE_RAM__)
+	spin_lock(&microcode_lock);
+	if (microcode_cache.valid && microcode_cache.sig == sig &&
+	    microcode_cache.pf == pf) {
+		spin_unlock(&microcode_lock);
+		return microcode_cache.patch;
+	}
+	spin_unlock(&microcode_lock);
+#endif
+
+#if !defined(__ROMCC__)
+	/* Skip the updates the index says don't match. The scan below still
+	 * checks the update it points to. ROMCC runs out of registers for the
+	 * lookup, so the bootblocks built with it scan the whole blob. */
+	offset = microcode_index_lookup(index, index_len, microcode_len,
+					sig, pf);
+	ucode_updates = (void *)((char *)ucode_updates + offset);
+	microcode_len -= offset;
+#endif
+
 	while (microcode_len >= sizeof(*ucode_updates)) {
 		/* Newer microcode updates include a size field, whereas older
 		 * containers set it at 0 and are exactly 2048 bytes long */
@@ -182,15 +299,25 @@ const void *intel_microcode_find(void)
 			break;
 		}
 
-		if ((ucode_updates->sig == sig) && (ucode_updates->pf & pf))
-			return ucode_updates;
+		if ((ucode_updates->sig == sig) && (ucode_updates->pf & pf)) {
+			found = ucode_updates;
+			break;
+		}
 
 		ucode_updates = (void *)((char *)ucode_updates + update_size);
 		microcode_len -= update_size;
 	}
 
-	/* ROMCC doesn't like NULL. */
-	return (void *)0;
+#if !defined(__ROMCC__) && !defined(__PRE_RAM__)
+	spin_lock(&microcode_lock);
+	microcode_cache.sig = sig;
+	microcode_cache.pf = pf;
+	microcode_cache.patch = found;
+	microcode_cache.valid = 1;
+	spin_unlock(&microcode_lock);
+#endif
+
+	return found;
 }
 
 void intel_update_microcode_from_cbfs(void)
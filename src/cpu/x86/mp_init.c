@@ -14,6 +14,7 @@
  * GNU General Public License for more details.
  */
 
+#include <cbmem.h>
 #include <console/console.h>
 #include <stdint.h>
 #include <rmodule.h>
@@ -36,8 +37,10 @@
 #include <smp/spinlock.h>
 #include <symbols.h>
 #include <thread.h>
+#include <timestamp.h>
 
 #define MAX_APIC_IDS 256
+#define MAX_AP_MSRS 32
 
 typedef void (*mp_callback_t)(void);
 
@@ -138,6 +141,21 @@ struct cpu_map {
 /* Keep track of APIC and device structure for each CPU. */
 static struct cpu_map cpus[CONFIG_MAX_CPUS];
 
+/* MSR writes recorded by mp_add_ap_msr() for the SIPI vector to replay. */
+static struct saved_msr ap_msrs[MAX_AP_MSRS];
+static int num_ap_msrs;
+
+/* Progress of each CPU through mp_init(), see struct mp_timing. */
+static struct mp_cpu_timing cpu_timing[CONFIG_MAX_CPUS];
+static uint64_t sipi_time;
+
+static inline uint64_t mp_time(void)
+{
+	if (!IS_ENABLED(CONFIG_COLLECT_TIMESTAMPS))
+		return 0;
+	return timestamp_get();
+}
+
 inline void barrier_wait(atomic_t *b)
 {
 	while (atomic_read(b) == 0)
@@ -212,13 +230,15 @@ static void park_this_cpu(void)
 	stop_this_cpu();
 }
 
-/* By the time APs call ap_init() caching has been setup, and microcode has
- * been loaded. */
+/* By the time APs call ap_init() caching has been setup, microcode has
+ * been loaded and the MSR writes from mp_add_ap_msr() have been done. */
 static void asmlinkage ap_init(unsigned int cpu)
 {
 	struct cpu_info *info;
 	int apic_id;
 
+	cpu_timing[cpu].entry = mp_time();
+
 	/* Ensure the local APIC is enabled */
 	enable_lapic();
 
@@ -288,8 +308,9 @@ static int save_bsp_msrs(char *start, int size)
 	/* 2 * num_var_mtrrs for base and mask. +1 for IA32_MTRR_DEF_TYPE. */
 	msr_count = 2 * num_var_mtrrs + NUM_FIXED_MTRRS + 1;
 
-	if ((msr_count * sizeof(struct saved_msr)) > size) {
-		printk(BIOS_CRIT, "Cannot mirror all %d msrs.\n", msr_count);
+	if (((msr_count + num_ap_msrs) * sizeof(struct saved_msr)) > size) {
+		printk(BIOS_CRIT, "Cannot mirror all %d msrs.\n",
+		       msr_count + num_ap_msrs);
 		return -1;
 	}
 
@@ -304,7 +325,27 @@ static int save_bsp_msrs(char *start, int size)
 
 	msr_entry = save_msr(MTRR_DEF_TYPE_MSR, msr_entry);
 
-	return msr_count;
+	/* The recorded writes go after the MTRRs so they can't be undone. */
+	memcpy(msr_entry, ap_msrs, num_ap_msrs * sizeof(*msr_entry));
+
+	return msr_count + num_ap_msrs;
+}
+
+int mp_add_ap_msr(unsigned int index, msr_t msr)
+{
+	struct saved_msr *entry;
+
+	if (num_ap_msrs == ARRAY_SIZE(ap_msrs)) {
+		printk(BIOS_ERR, "No room for AP MSR 0x%x.\n", index);
+		return -1;
+	}
+
+	entry = &ap_msrs[num_ap_msrs++];
+	entry->index = index;
+	entry->lo = msr.lo;
+	entry->hi = msr.hi;
+
+	return 0;
 }
 
 static atomic_t *load_sipi_vector(struct mp_params *mp_params)
@@ -586,6 +627,39 @@ static void init_bsp(struct bus *cpu_bus)
 	cpus[info->index].apic_id = cpu_path.apic.apic_id;
 }
 
+/* Publish how long each CPU took to get through the flight plan. */
+static void save_mp_timing(int num_cpus)
+{
+	struct mp_timing *t;
+	uint64_t slowest = 0;
+	int freq = timestamp_tick_freq_mhz();
+	int i;
+
+	t = cbmem_add(CBMEM_ID_MP_TIMING,
+		      sizeof(*t) + num_cpus * sizeof(t->cpus[0]));
+	if (t == NULL)
+		return;
+
+	t->sipi = sipi_time;
+	t->done = timestamp_get();
+	t->tick_freq_mhz = freq;
+	t->num_cpus = num_cpus;
+	for (i = 0; i < num_cpus; i++) {
+		t->cpus[i] = cpu_timing[i];
+		t->cpus[i].apic_id = cpus[i].apic_id;
+		/* Skip APs that never checked in. */
+		if (i == 0 || cpu_timing[i].init_done == 0)
+			continue;
+		if (cpu_timing[i].init_done - sipi_time > slowest)
+			slowest = cpu_timing[i].init_done - sipi_time;
+	}
+
+	if (freq > 0 && num_cpus > 1)
+		printk(BIOS_DEBUG, "MP: slowest AP initialized %llu us after "
+		       "SIPI, all done after %llu us.\n", slowest / freq,
+		       (t->done - sipi_time) / freq);
+}
+
 /*
  * mp_init() will set up the SIPI vector and bring up the APs according to
  * mp_params. Each flight record will be executed according to the plan. Note
@@ -593,8 +667,9 @@ static void init_bsp(struct bus *cpu_bus)
  * up to the chipset or mainboard to either e820 reserve this area or save this
  * region prior to calling mp_init() and restoring it after mp_init returns.
  *
- * At the time mp_init() is called the MTRR MSRs are mirrored into APs then
- * caching is enabled before running the flight plan.
+ * At the time mp_init() is called the MTRR MSRs are mirrored into APs, the
+ * MSR writes recorded with mp_add_ap_msr() are replayed on all APs in parallel,
+ * then caching is enabled before running the flight plan.
  *
  * The MP initialization has the following properties:
  * 1. APs are brought up in parallel.
@@ -642,6 +717,7 @@ static int mp_init(struct bus *cpu_bus, struct mp_params *p)
 
 	/* Start the APs providing number of APs and the cpus_entered field. */
 	global_num_aps = p->num_cpus - 1;
+	sipi_time = mp_time();
 	if (start_aps(cpu_bus, global_num_aps, ap_count) < 0) {
 		mdelay(1000);
 		printk(BIOS_DEBUG, "%d/%d eventually checked in?\n",
@@ -650,7 +726,13 @@ static int mp_init(struct bus *cpu_bus, struct mp_params *p)
 	}
 
 	/* Walk the flight plan for the BSP. */
-	return bsp_do_flight_plan(p);
+	if (bsp_do_flight_plan(p) < 0)
+		return -1;
+
+	if (IS_ENABLED(CONFIG_COLLECT_TIMESTAMPS))
+		save_mp_timing(p->num_cpus);
+
+	return 0;
 }
 
 /* Calls cpu_initialize(info->index) which calls the coreboot CPU drivers. */
@@ -659,6 +741,7 @@ static void mp_initialize_cpu(void)
 	/* Call back into driver infrastructure for the AP initialization.   */
 	struct cpu_info *info = cpu_info();
 	cpu_initialize(info->index);
+	cpu_timing[info->index].init_done = mp_time();
 }
 
 /* Returns APIC id for coreboot CPU number or < 0 on failure. */
@@ -1011,6 +1094,10 @@ int mp_init_with_smm(struct bus *cpu_bus, const struct mp_ops *mp_ops)
 	if (mp_state.ops.get_microcode_info != NULL)
 		mp_state.ops.get_microcode_info(&mp_params.microcode_pointer,
 			&mp_params.parallel_microcode_load);
+	/* Gather the MSR writes for the APs to replay. */
+	num_ap_msrs = 0;
+	if (mp_state.ops.add_ap_msrs != NULL)
+		mp_state.ops.add_ap_msrs();
 	mp_params.adjust_apic_id = mp_state.ops.adjust_cpu_apic_entry;
 	mp_params.flight_plan = &mp_steps[0];
 	mp_params.num_records = ARRAY_SIZE(mp_steps);
@@ -105,26 +105,23 @@ static void enable_var_mtrr(unsigned char deftype)
 #define RANGE_TO_PHYS_ADDR(x) (((resource_t)(x)) << RANGE_SHIFT)
 #define NUM_FIXED_MTRRS (NUM_FIXED_RANGES / RANGES_PER_FIXED_MTRR)
 
-/* The minimum alignment while handling variable MTRR ranges is 64MiB. */
-#define MTRR_MIN_ALIGN PHYS_TO_RANGE_ADDR(64 << 20)
 /* Helpful constants. */
 #define RANGE_1MB PHYS_TO_RANGE_ADDR(1 << 20)
 #define RANGE_4GB (1 << (ADDR_SHIFT_TO_RANGE_SHIFT(32)))
+/* Largest variable MTRR the 32-bit range arithmetic can describe. */
+#define RANGE_LIMIT (1U << 31)
 
 /*
- * The default MTRR type selection uses 3 approaches for selecting the
- * optimal number of variable MTRRs.  For each range do 3 calculations:
- *   1. UC as default type with no holes at top of range.
- *   2. UC as default using holes at top of range.
- *   3. WB as default.
- * If using holes is optimal for a range when UC is the default type the
- * tag is updated to direct the commit routine to use a hole at the top
- * of a range.
+ * Variable MTRRs are searched for per default type. With WB as default every
+ * range of another type is covered exactly. With UC as default, ranges of
+ * the same type and the default type gaps between them can be covered by a
+ * single larger, better aligned range with the gaps and the excess carved
+ * out by UC MTRRs (UC takes precedence over all other types). The solver
+ * picks the grouping and the covering range that need the fewest MTRRs.
  */
-#define MTRR_ALGO_SHIFT (8)
-#define MTRR_TAG_MASK ((1 << MTRR_ALGO_SHIFT) - 1)
-/* If the default type is UC use the hole carving algorithm for a range. */
-#define MTRR_RANGE_UC_USE_HOLE (1 << MTRR_ALGO_SHIFT)
+#define MTRR_SOLVER_SPANS 64
+/* Maximum number of ranges covered by one larger range. */
+#define MTRR_SOLVER_GROUP 8
 
 static inline uint32_t range_entry_base_mtrr_addr(struct range_entry *r)
 {
@@ -138,7 +135,7 @@ static inline uint32_t range_entry_end_mtrr_addr(struct range_entry *r)
 
 static inline int range_entry_mtrr_type(struct range_entry *r)
 {
-	return range_entry_tag(r) & MTRR_TAG_MASK;
+	return range_entry_tag(r);
 }
 
 static int filter_vga_wrcomb(struct device *dev, struct resource *res)
@@ -443,24 +440,44 @@ static void prep_var_mtrr(struct var_mtrr_state *var_state,
 	regs->mask.hi = rsize >> 32;
 }
 
-static void calc_var_mtrr_range(struct var_mtrr_state *var_state,
-				uint32_t base, uint32_t size, int mtrr_type)
+/* Size of the largest MTRR that can start at base and fits into size. */
+static inline uint32_t var_mtrr_block_size(uint32_t base, uint32_t size)
+{
+	uint32_t addr_lsb;
+	uint32_t size_msb;
+
+	addr_lsb = fls(base);
+	size_msb = fms(size);
+
+	/* All MTRR entries need to have their base aligned to the mask
+	 * size. The maximum size is calculated by a function of the
+	 * min base bit set and maximum size bit set. */
+	if (addr_lsb > size_msb)
+		return 1U << size_msb;
+	return 1U << addr_lsb;
+}
+
+/* Number of MTRRs calc_var_mtrr_range() uses to cover a range exactly. */
+static int var_mtrr_count(uint32_t base, uint32_t size)
 {
+	int count = 0;
+
 	while (size != 0) {
-		uint32_t addr_lsb;
-		uint32_t size_msb;
-		uint32_t mtrr_size;
+		const uint32_t mtrr_size = var_mtrr_block_size(base, size);
+
+		size -= mtrr_size;
+		base += mtrr_size;
+		count++;
+	}
 
-		addr_lsb = fls(base);
-		size_msb = fms(size);
+	return count;
+}
 
-		/* All MTRR entries need to have their base aligned to the mask
-		 * size. The maximum size is calculated by a function of the
-		 * min base bit set and maximum size bit set. */
-		if (addr_lsb > size_msb)
-			mtrr_size = 1 << size_msb;
-		else
-			mtrr_size = 1 << addr_lsb;
+static void calc_var_mtrr_range(struct var_mtrr_state *var_state,
+				uint32_t base, uint32_t size, int mtrr_type)
+{
+	while (size != 0) {
+		const uint32_t mtrr_size = var_mtrr_block_size(base, size);
 
 		if (var_state->prepare_msrs)
 			prep_var_mtrr(var_state, base, mtrr_size, mtrr_type);
@@ -471,150 +488,251 @@ static void calc_var_mtrr_range(struct var_mtrr_state *var_state,
 	}
 }
 
-static void calc_var_mtrrs_with_hole(struct var_mtrr_state *var_state,
-				     struct range_entry *r)
-{
-	uint32_t a1, a2, b1, b2;
-	int mtrr_type;
-	struct range_entry *next;
-
-	/*
-	 * Determine MTRRs based on the following algorithm for the given entry:
-	 * +------------------+ b2 = ALIGN_UP(end)
-	 * |  0 or more bytes | <-- hole is carved out between b1 and b2
-	 * +------------------+ a2 = b1 = end
-	 * |                  |
-	 * +------------------+ a1 = begin
-	 *
-	 * Thus, there are 3 sub-ranges to configure variable MTRRs for.
-	 */
-	mtrr_type = range_entry_mtrr_type(r);
+/* A range that needs a type other than the default, in range units. */
+struct var_mtrr_span {
+	uint32_t begin;
+	uint32_t end;
+	int type;
+};
 
-	a1 = range_entry_base_mtrr_addr(r);
-	a2 = range_entry_end_mtrr_addr(r);
+/* Returns 0 if the entry doesn't need variable MTRRs. */
+static int var_mtrr_span_init(const struct var_mtrr_state *var_state,
+			      struct range_entry *r,
+			      struct var_mtrr_span *span)
+{
+	uint32_t begin = range_entry_base_mtrr_addr(r);
+	uint32_t end = range_entry_end_mtrr_addr(r);
 
 	/* The end address is within the first 1MiB. The fixed MTRRs take
 	 * precedence over the variable ones. Therefore this range
 	 * can be ignored. */
-	if (a2 <= RANGE_1MB)
-		return;
+	if (end <= RANGE_1MB)
+		return 0;
 
 	/* Again, the fixed MTRRs take precedence so the beginning
 	 * of the range can be set to 0 if it starts at or below 1MiB. */
-	if (a1 <= RANGE_1MB)
-		a1 = 0;
+	if (begin <= RANGE_1MB)
+		begin = 0;
 
 	/* If the range starts above 4GiB the processing is done. */
-	if (!var_state->above4gb && a1 >= RANGE_4GB)
-		return;
+	if (!var_state->above4gb && begin >= RANGE_4GB)
+		return 0;
 
 	/* Clip the upper address to 4GiB if addresses above 4GiB
 	 * are not being processed. */
-	if (!var_state->above4gb && a2 > RANGE_4GB)
-		a2 = RANGE_4GB;
+	if (!var_state->above4gb && end > RANGE_4GB)
+		end = RANGE_4GB;
 
-	next = memranges_next_entry(var_state->addr_space, r);
+	span->begin = begin;
+	span->end = end;
+	span->type = range_entry_mtrr_type(r);
 
-	b1 = a2;
-
-	/* First check if a1 is >= 4GiB and the current entry is the last
-	 * entry. If so perform an optimization of covering a larger range
-	 * defined by the base address' alignment. */
-	if (a1 >= RANGE_4GB && next == NULL) {
-		uint32_t addr_lsb;
+	return span->type != var_state->def_mtrr_type;
+}
 
-		addr_lsb = fls(a1);
-		b2 = (1 << addr_lsb) + a1;
-		if (b2 >= a2) {
-			calc_var_mtrr_range(var_state, a1, b2 - a1, mtrr_type);
-			return;
+/*
+ * Find the cheapest way to cover spans[first..last] with UC as default
+ * type: one range [*cover_begin, *cover_end) of their type around all of
+ * them, with everything in it that isn't part of a span carved out by UC
+ * MTRRs. The covering range may grow down to lo and up to hi, which are
+ * the closest addresses that need a type other than UC. Above tail_free
+ * nothing has to be carved out. Returns the number of MTRRs needed.
+ */
+static int var_mtrr_group_cost(const struct var_mtrr_span *spans,
+			       int first, int last,
+			       uint32_t lo, uint32_t hi, uint32_t tail_free,
+			       uint32_t *cover_begin, uint32_t *cover_end)
+{
+	const uint32_t begin = spans[first].begin;
+	const uint32_t end = spans[last].end;
+	uint32_t a, prev_a, b, prev_b;
+	int gaps, best, i, j;
+
+	if (hi < end)
+		hi = end;
+
+	gaps = 0;
+	for (i = first; i < last; i++)
+		gaps += var_mtrr_count(spans[i].end,
+				       spans[i + 1].begin - spans[i].end);
+
+	best = -1;
+	prev_a = ~0;
+	for (i = 0; i <= 31; i++) {
+		a = ALIGN_DOWN(begin, 1U << i);
+		if (a < lo)
+			break;
+		if (a == prev_a)
+			continue;
+		prev_a = a;
+
+		prev_b = 0;
+		for (j = 0; j <= 31; j++) {
+			int cost;
+
+			b = ALIGN_UP(end, 1U << j);
+			if (b < end || b > hi)
+				break;
+			if (b == prev_b)
+				continue;
+			prev_b = b;
+
+			cost = gaps + var_mtrr_count(a, b - a) +
+				var_mtrr_count(a, begin - a);
+			if (b > tail_free)
+				cost += var_mtrr_count(end,
+						MAX(tail_free, end) - end);
+			else
+				cost += var_mtrr_count(end, b - end);
+
+			if (best < 0 || cost < best) {
+				best = cost;
+				*cover_begin = a;
+				*cover_end = b;
+			}
 		}
 	}
 
-	/* Handle the min alignment roundup case. */
-	b2 = ALIGN_UP(a2, MTRR_MIN_ALIGN);
-
-	/* Check against the next range. If the current range_entry is the
-	 * last entry then carving a hole is no problem. If the current entry
-	 * isn't the last entry then check that the last entry covers the
-	 * entire hole range with the default mtrr type. */
-	if (next != NULL &&
-	    (range_entry_mtrr_type(next) != var_state->def_mtrr_type ||
-	     range_entry_end_mtrr_addr(next) < b2)) {
-		calc_var_mtrr_range(var_state, a1, a2 - a1, mtrr_type);
-		return;
-	}
-
-	calc_var_mtrr_range(var_state, a1, b2 - a1, mtrr_type);
-	calc_var_mtrr_range(var_state, b1, b2 - b1, var_state->def_mtrr_type);
+	return best;
 }
 
-static void calc_var_mtrrs_without_hole(struct var_mtrr_state *var_state,
-					struct range_entry *r)
+static void calc_var_mtrrs_group(struct var_mtrr_state *var_state,
+				 const struct var_mtrr_span *spans,
+				 int first, int last,
+				 uint32_t cover_begin, uint32_t cover_end,
+				 uint32_t tail_free)
 {
-	uint32_t a1, a2, b1, b2, c1, c2;
-	int mtrr_type;
-
-	/*
-	 * For each range that meets the non-default type process it in the
-	 * following manner:
-	 * +------------------+ c2 = end
-	 * |  0 or more bytes |
-	 * +------------------+ b2 = c1 = ALIGN_DOWN(end)
-	 * |                  |
-	 * +------------------+ b1 = a2 = ALIGN_UP(begin)
-	 * |  0 or more bytes |
-	 * +------------------+ a1 = begin
-	 *
-	 * Thus, there are 3 sub-ranges to configure variable MTRRs for.
-	 */
-	mtrr_type = range_entry_mtrr_type(r);
+	const int mtrr_type = spans[first].type;
+	const int def_type = var_state->def_mtrr_type;
+	uint32_t top;
+	int i;
 
-	a1 = range_entry_base_mtrr_addr(r);
-	c2 = range_entry_end_mtrr_addr(r);
+	calc_var_mtrr_range(var_state, cover_begin, cover_end - cover_begin,
+			    mtrr_type);
+	calc_var_mtrr_range(var_state, cover_begin,
+			    spans[first].begin - cover_begin, def_type);
+	for (i = first; i < last; i++)
+		calc_var_mtrr_range(var_state, spans[i].end,
+				    spans[i + 1].begin - spans[i].end,
+				    def_type);
+	top = cover_end;
+	if (top > tail_free)
+		top = MAX(tail_free, spans[last].end);
+	calc_var_mtrr_range(var_state, spans[last].end,
+			    top - spans[last].end, def_type);
+}
 
-	/* The end address is within the first 1MiB. The fixed MTRRs take
-	 * precedence over the variable ones. Therefore this range
-	 * can be ignored. */
-	if (c2 <= RANGE_1MB)
-		return;
+static void calc_var_mtrrs_uc_default(struct var_mtrr_state *var_state,
+				      struct var_mtrr_span *spans, int n,
+				      uint32_t limit, uint32_t tail_free)
+{
+	/* Lowest cost covering spans[0..i-1], and the group ending there. */
+	int cost[MTRR_SOLVER_SPANS + 1];
+	int group_first[MTRR_SOLVER_SPANS + 1];
+	int i, j;
+
+	cost[0] = 0;
+	for (i = 1; i <= n; i++) {
+		const int last = i - 1;
+		const uint32_t hi = (i < n) ? spans[i].begin : limit;
+
+		cost[i] = -1;
+		for (j = last; j >= 0 && last - j < MTRR_SOLVER_GROUP; j--) {
+			const uint32_t lo = (j > 0) ? spans[j - 1].end : 0;
+			uint32_t cover_begin, cover_end;
+			int c;
+
+			/* Other types can't be carved out. */
+			if (spans[j].type != spans[last].type)
+				break;
+
+			c = var_mtrr_group_cost(spans, j, last, lo, hi,
+						tail_free, &cover_begin,
+						&cover_end);
+			if (c >= 0 && (cost[i] < 0 || cost[j] + c < cost[i])) {
+				cost[i] = cost[j] + c;
+				group_first[i] = j;
+			}
+		}
+	}
 
-	/* Again, the fixed MTRRs take precedence so the beginning
-	 * of the range can be set to 0 if it starts at or below 1MiB. */
-	if (a1 <= RANGE_1MB)
-		a1 = 0;
+	/* Emit the chosen groups, last to first. */
+	for (i = n; i > 0; i = j) {
+		const int last = i - 1;
+		const uint32_t hi = (i < n) ? spans[i].begin : limit;
+		uint32_t lo, cover_begin, cover_end;
+
+		j = group_first[i];
+		lo = (j > 0) ? spans[j - 1].end : 0;
+		var_mtrr_group_cost(spans, j, last, lo, hi, tail_free,
+				    &cover_begin, &cover_end);
+		calc_var_mtrrs_group(var_state, spans, j, last,
+				     cover_begin, cover_end, tail_free);
+	}
+}
 
-	/* If the range starts above 4GiB the processing is done. */
-	if (!var_state->above4gb && a1 >= RANGE_4GB)
-		return;
+static void calc_var_mtrrs_for_default(struct var_mtrr_state *var_state)
+{
+	struct var_mtrr_span spans[MTRR_SOLVER_SPANS];
+	struct var_mtrr_span span;
+	struct range_entry *r;
+	uint32_t limit, tail_free;
+	int n = 0;
+
+	/* Nothing may be carved out above 4GiB if the range isn't managed
+	 * by variable MTRRs. */
+	limit = RANGE_4GB;
+	if (var_state->above4gb) {
+		limit = RANGE_LIMIT;
+		if (var_state->address_bits - RANGE_SHIFT < 31)
+			limit = 1U << (var_state->address_bits - RANGE_SHIFT);
+	}
+	/* Nothing is mapped above the last range if it starts above 4GiB,
+	 * so a range covering it may extend further without being carved
+	 * out at the top. */
+	tail_free = limit;
+
+	memranges_each_entry(r, var_state->addr_space) {
+		if (!var_mtrr_span_init(var_state, r, &span)) {
+			tail_free = limit;
+			continue;
+		}
 
-	/* Clip the upper address to 4GiB if addresses above 4GiB
-	 * are not being processed. */
-	if (!var_state->above4gb && c2 > RANGE_4GB)
-		c2 = RANGE_4GB;
+		tail_free = span.begin >= RANGE_4GB ? span.end : limit;
+
+		/* Only the default type can be carved out with WB as
+		 * default, so cover every range exactly. Same for ranges
+		 * beyond what the solver keeps track of. */
+		if (var_state->def_mtrr_type != MTRR_TYPE_UNCACHEABLE ||
+		    n == MTRR_SOLVER_SPANS) {
+			calc_var_mtrr_range(var_state, span.begin,
+					    span.end - span.begin, span.type);
+			if (n == MTRR_SOLVER_SPANS)
+				limit = MIN(limit, span.begin);
+			continue;
+		}
 
-	/* Don't align up or down on the range if it is smaller
-	 * than the minimum granularity. */
-	if ((c2 - a1) < MTRR_MIN_ALIGN) {
-		calc_var_mtrr_range(var_state, a1, c2 - a1, mtrr_type);
-		return;
+		spans[n++] = span;
 	}
 
-	b1 = a2 = ALIGN_UP(a1, MTRR_MIN_ALIGN);
-	b2 = c1 = ALIGN_DOWN(c2, MTRR_MIN_ALIGN);
+	if (n > 0)
+		calc_var_mtrrs_uc_default(var_state, spans, n,
+					  limit, MIN(tail_free, limit));
+}
 
-	calc_var_mtrr_range(var_state, a1, a2 - a1, mtrr_type);
-	calc_var_mtrr_range(var_state, b1, b2 - b1, mtrr_type);
-	calc_var_mtrr_range(var_state, c1, c2 - c1, mtrr_type);
+static int calc_var_mtrrs_count(struct var_mtrr_state *var_state,
+				int def_type)
+{
+	var_state->def_mtrr_type = def_type;
+	var_state->mtrr_index = 0;
+	calc_var_mtrrs_for_default(var_state);
+	return var_state->mtrr_index;
 }
 
 static void __calc_var_mtrrs(struct memranges *addr_space,
 			     int above4gb, int address_bits,
 			     int *num_def_wb_mtrrs, int *num_def_uc_mtrrs)
 {
-	int wb_deftype_count;
-	int uc_deftype_count;
-	struct range_entry *r;
 	struct var_mtrr_state var_state;
 
 	/* The default MTRR cacheability type is determined by calculating
@@ -625,69 +743,9 @@ static void __calc_var_mtrrs(struct memranges *addr_space,
 	var_state.address_bits = address_bits;
 	var_state.prepare_msrs = 0;
 
-	wb_deftype_count = 0;
-	uc_deftype_count = 0;
-
-	/*
-	 * For each range do 3 calculations:
-	 *   1. UC as default type with no holes at top of range.
-	 *   2. UC as default using holes at top of range.
-	 *   3. WB as default.
-	 * The lowest count is then used as default after totaling all
-	 * MTRRs. Note that the optimal algorithm for UC default is marked in
-	 * the tag of each range regardless of final decision.  UC takes
-	 * precedence in the MTRR architecture. Therefore, only holes can be
-	 * used when the type of the region is MTRR_TYPE_WRBACK with
-	 * MTRR_TYPE_UNCACHEABLE as the default type.
-	 */
-	memranges_each_entry(r, var_state.addr_space) {
-		int mtrr_type;
-
-		mtrr_type = range_entry_mtrr_type(r);
-
-		if (mtrr_type != MTRR_TYPE_UNCACHEABLE) {
-			int uc_hole_count;
-			int uc_no_hole_count;
-
-			var_state.def_mtrr_type = MTRR_TYPE_UNCACHEABLE;
-			var_state.mtrr_index = 0;
-
-			/* No hole calculation. */
-			calc_var_mtrrs_without_hole(&var_state, r);
-			uc_no_hole_count = var_state.mtrr_index;
-
-			/* Hole calculation only if type is WB. The 64 number
-			 * is a count that is unachievable, thus making it
-			 * a default large number in the case of not doing
-			 * the hole calculation. */
-			uc_hole_count = 64;
-			if (mtrr_type == MTRR_TYPE_WRBACK) {
-				var_state.mtrr_index = 0;
-				calc_var_mtrrs_with_hole(&var_state, r);
-				uc_hole_count = var_state.mtrr_index;
-			}
-
-			/* Mark the entry with the optimal algorithm. */
-			if (uc_no_hole_count < uc_hole_count) {
-				uc_deftype_count += uc_no_hole_count;
-			} else {
-				unsigned long new_tag;
-
-				new_tag = mtrr_type | MTRR_RANGE_UC_USE_HOLE;
-				range_entry_update_tag(r, new_tag);
-				uc_deftype_count += uc_hole_count;
-			}
-		}
-
-		if (mtrr_type != MTRR_TYPE_WRBACK) {
-			var_state.mtrr_index = 0;
-			var_state.def_mtrr_type = MTRR_TYPE_WRBACK;
-			calc_var_mtrrs_without_hole(&var_state, r);
-			wb_deftype_count += var_state.mtrr_index;
-		}
-	}
-	*num_def_wb_mtrrs = wb_deftype_count;
-	*num_def_uc_mtrrs = uc_deftype_count;
+	*num_def_wb_mtrrs = calc_var_mtrrs_count(&var_state, MTRR_TYPE_WRBACK);
+	*num_def_uc_mtrrs = calc_var_mtrrs_count(&var_state,
+						 MTRR_TYPE_UNCACHEABLE);
 }
 
 static int calc_var_mtrrs(struct memranges *addr_space,
@@ -724,7 +782,6 @@ static void prepare_var_mtrrs(struct memranges *addr_space, int def_type,
 				int above4gb, int address_bits,
 				struct var_mtrr_solution *sol)
 {
-	struct range_entry *r;
 	struct var_mtrr_state var_state;
 
 	var_state.addr_space = addr_space;
@@ -736,19 +793,10 @@ static void prepare_var_mtrrs(struct memranges *addr_space, int def_type,
 	var_state.def_mtrr_type = def_type;
 	var_state.regs = &sol->regs[0];
 
-	memranges_each_entry(r, var_state.addr_space) {
-		if (range_entry_mtrr_type(r) == def_type)
-			continue;
-
-		if (def_type == MTRR_TYPE_UNCACHEABLE &&
-		    (range_entry_tag(r) & MTRR_RANGE_UC_USE_HOLE))
-			calc_var_mtrrs_with_hole(&var_state, r);
-		else
-			calc_var_mtrrs_without_hole(&var_state, r);
-	}
+	calc_var_mtrrs_for_default(&var_state);
 
 	/* Update the solution. */
-	sol->num_used = var_state.mtrr_index;
+	sol->num_used = MIN(var_state.mtrr_index, total_mtrrs);
 }
 
 static void commit_var_mtrrs(const struct var_mtrr_solution *sol)
@@ -848,9 +896,6 @@ void mtrr_use_temp_range(uintptr_t begin, size_t size, int type)
 	memranges_each_entry(r, orig) {
 		unsigned long tag = range_entry_tag(r);
 
-		/* Remove any special tags from original solution. */
-		tag &= ~MTRR_RANGE_UC_USE_HOLE;
-
 		/* Remove any write combining MTRRs from the temporary
 		 * solution as it just fragments the address space. */
 		if (tag == MTRR_TYPE_WRCOMB)
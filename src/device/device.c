@@ -245,61 +245,79 @@ static void read_resources(struct bus *bus)
 	       dev_path(bus->dev), bus->secondary, bus->link_num);
 }
 
-struct pick_largest_state {
-	struct resource *last;
-	struct device *result_dev;
-	struct resource *result;
-	int seen_last;
+struct bus_resource {
+	struct device *dev;
+	struct resource *res;
 };
 
-static void pick_largest_resource(void *gp, struct device *dev,
-				  struct resource *resource)
+/*
+ * The resources of the bus being allocated, largest alignment and size
+ * first. It is filled once per bus and type instead of searching the bus
+ * for the next largest resource over and over. A single list is enough
+ * since compute_resources() and allocate_resources() don't recurse while
+ * they walk it.
+ */
+static struct {
+	struct bus_resource *entries;
+	size_t count;
+	size_t max;
+} bus_resources;
+
+static int resource_is_larger(const struct resource *a,
+			      const struct resource *b)
 {
-	struct pick_largest_state *state = gp;
-	struct resource *last;
+	return (a->align > b->align) ||
+	       ((a->align == b->align) && (a->size > b->size));
+}
 
-	last = state->last;
+static void add_bus_resource(void *gp, struct device *dev,
+			     struct resource *resource)
+{
+	struct bus_resource *entries;
+	size_t lo, hi, mid;
 
-	/* Be certain to pick the successor to last. */
-	if (resource == last) {
-		state->seen_last = 1;
-		return;
-	}
 	if (resource->flags & IORESOURCE_FIXED)
 		return;	/* Skip it. */
-	if (last && ((last->align < resource->align) ||
-		     ((last->align == resource->align) &&
-		      (last->size < resource->size)) ||
-		     ((last->align == resource->align) &&
-		      (last->size == resource->size) && (!state->seen_last)))) {
-		return;
+
+	if (bus_resources.count == bus_resources.max) {
+		bus_resources.max = bus_resources.max ?
+				    2 * bus_resources.max : 64;
+		entries = malloc(bus_resources.max * sizeof(*entries));
+		if (!entries)
+			die("Couldn't allocate the resource list!\n");
+		if (bus_resources.count)
+			memcpy(entries, bus_resources.entries,
+			       bus_resources.count * sizeof(*entries));
+		free(bus_resources.entries);
+		bus_resources.entries = entries;
 	}
-	if (!state->result ||
-	    (state->result->align < resource->align) ||
-	    ((state->result->align == resource->align) &&
-	     (state->result->size < resource->size))) {
-		state->result_dev = dev;
-		state->result = resource;
+
+	/*
+	 * Insert it behind all resources that are at least as large, so
+	 * resources of the same size stay in the order of the bus.
+	 */
+	entries = bus_resources.entries;
+	lo = 0;
+	hi = bus_resources.count;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (resource_is_larger(resource, entries[mid].res))
+			hi = mid;
+		else
+			lo = mid + 1;
 	}
+	memmove(&entries[lo + 1], &entries[lo],
+		(bus_resources.count - lo) * sizeof(*entries));
+	entries[lo].dev = dev;
+	entries[lo].res = resource;
+	bus_resources.count++;
 }
 
-static struct device *largest_resource(struct bus *bus,
-				       struct resource **result_res,
-				       unsigned long type_mask,
-				       unsigned long type)
+static void sort_bus_resources(struct bus *bus, unsigned long type_mask,
+			       unsigned long type)
 {
-	struct pick_largest_state state;
-
-	state.last = *result_res;
-	state.result_dev = NULL;
-	state.result = NULL;
-	state.seen_last = 0;
-
-	search_bus_resources(bus, type_mask, type, pick_largest_resource,
-			     &state);
-
-	*result_res = state.result;
-	return state.result_dev;
+	bus_resources.count = 0;
+	search_bus_resources(bus, type_mask, type, add_bus_resource, NULL);
 }
 
 /**
@@ -341,6 +359,7 @@ static void compute_resources(struct bus *bus, struct resource *bridge,
 	struct device *dev;
 	struct resource *resource;
 	resource_t base;
+	size_t i;
 	base = round(bridge->base, bridge->align);
 
 	printk(BIOS_SPEW,  "%s %s: base: %llx size: %llx align: %d gran: %d"
@@ -389,15 +408,15 @@ static void compute_resources(struct bus *bus, struct resource *bridge,
 		}
 	}
 
-	/* Remember we haven't found anything yet. */
-	resource = NULL;
-
 	/*
 	 * Walk through all the resources on the current bus and compute the
 	 * amount of address space taken by them. Take granularity and
 	 * alignment into account.
 	 */
-	while ((dev = largest_resource(bus, &resource, type_mask, type))) {
+	sort_bus_resources(bus, type_mask, type);
+	for (i = 0; i < bus_resources.count; i++) {
+		dev = bus_resources.entries[i].dev;
+		resource = bus_resources.entries[i].res;
 
 		/* Size 0 resources can be skipped. */
 		if (!resource->size)
@@ -485,6 +504,7 @@ static void allocate_resources(struct bus *bus, struct resource *bridge,
 	struct device *dev;
 	struct resource *resource;
 	resource_t base;
+	size_t i;
 	base = bridge->base;
 
 	printk(BIOS_SPEW, "%s %s: base:%llx size:%llx align:%d gran:%d "
@@ -492,14 +512,14 @@ static void allocate_resources(struct bus *bus, struct resource *bridge,
 	       resource2str(bridge),
 	       base, bridge->size, bridge->align, bridge->gran, bridge->limit);
 
-	/* Remember we haven't found anything yet. */
-	resource = NULL;
-
 	/*
 	 * Walk through all the resources on the current bus and allocate them
 	 * address space.
 	 */
-	while ((dev = largest_resource(bus, &resource, type_mask, type))) {
+	sort_bus_resources(bus, type_mask, type);
+	for (i = 0; i < bus_resources.count; i++) {
+		dev = bus_resources.entries[i].dev;
+		resource = bus_resources.entries[i].res;
 
 		/* Propagate the bridge limit to the resource register. */
 		if (resource->limit > bridge->limit)
@@ -107,6 +107,12 @@ rdl     - Function to read a dword from an address
 wrb		- Function to write a byte to an address
 wrw    	- Function to write a word to an address
 wrl    	- Function to write a dword to an address
+page	- Optional function returning a host pointer to the start of the
+		  X86EMU_PAGE_SIZE aligned page containing an address, if the
+		  functions above treat that page as plain memory. Returns NULL for
+		  pages that have to be accessed through the functions above. The
+		  emulator uses it to fetch instructions and to run REP MOVS/STOS
+		  without calling the functions above for every byte.
 ****************************************************************************/
 typedef struct {
 	u8  	(X86APIP rdb)(u32 addr);
@@ -115,8 +121,11 @@ typedef struct {
 	void 	(X86APIP wrb)(u32 addr, u8 val);
 	void 	(X86APIP wrw)(u32 addr, u16 val);
 	void	(X86APIP wrl)(u32 addr, u32 val);
+	u8 *	(X86APIP page)(u32 addr);
 	} X86EMU_memFuncs;
 
+#define X86EMU_PAGE_SIZE	0x1000
+
 /****************************************************************************
   Here are the default memory read and write
   function in case they are needed as fallbacks.
@@ -127,6 +136,7 @@ extern u32 X86API rdl(u32 addr);
 extern void X86API wrb(u32 addr, u8 val);
 extern void X86API wrw(u32 addr, u16 val);
 extern void X86API wrl(u32 addr, u32 val);
+extern u8 * X86API mem_page(u32 addr);
 
 #pragma	pack()
 
@@ -279,7 +279,8 @@ void vbe_set_graphics(void)
 	}
 	decdata = malloc(sizeof(*decdata));
 	int ret = 0;
-	ret = jpeg_decode(jpeg, framebuffer, 1024, 768, 16, decdata);
+	ret = jpeg_decode_scaled(jpeg, framebuffer, 1024, 768, 16,
+		le16_to_cpu(mode_info.vesa.bytes_per_scanline), 1, decdata);
 #endif
 }
 
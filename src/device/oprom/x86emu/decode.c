@@ -39,8 +39,80 @@
 
 #include "x86emui.h"
 
+/*------------------------- Global Variables ------------------------------*/
+
+/* Page instructions were last fetched from. code_page is NULL if the page
+ * has to be read through the memory functions. */
+static u32 code_page_addr = 1;
+static u8 *code_page;
+
 /*----------------------------- Implementation ----------------------------*/
 
+/****************************************************************************
+REMARKS:
+Forgets the page instructions were last fetched from. Has to be called
+whenever the memory functions or the emulator memory change.
+****************************************************************************/
+void x86emu_flush_code_page(void)
+{
+    code_page_addr = 1;     /* never a page address */
+    code_page = NULL;
+}
+
+/****************************************************************************
+PARAMETERS:
+addr    - Emulator memory address of the instruction bytes
+size    - Number of bytes to fetch
+
+RETURNS:
+Host pointer to the instruction bytes, NULL if they have to be read through
+the memory functions.
+
+REMARKS:
+Instructions are read from the page they are in every time, not copied, so
+code that modifies itself sees its own writes.
+****************************************************************************/
+static u8 *code_ptr(
+    u32 addr,
+    u32 size)
+{
+    u32 page = addr & ~(X86EMU_PAGE_SIZE - 1);
+    u32 offset = addr & (X86EMU_PAGE_SIZE - 1);
+
+    if (page != code_page_addr) {
+        code_page_addr = page;
+        code_page = sys_page ? (*sys_page)(page) : NULL;
+    }
+    if (code_page == NULL || offset > X86EMU_PAGE_SIZE - size)
+        return NULL;
+    return code_page + offset;
+}
+
+static u8 fetch_code_byte(
+    u32 addr)
+{
+    u8 *p = code_ptr(addr, 1);
+
+    return p ? p[0] : (*sys_rdb)(addr);
+}
+
+static u16 fetch_code_word(
+    u32 addr)
+{
+    u8 *p = code_ptr(addr, 2);
+
+    return p ? p[0] | p[1] << 8 : (*sys_rdw)(addr);
+}
+
+static u32 fetch_code_long(
+    u32 addr)
+{
+    u8 *p = code_ptr(addr, 4);
+
+    return p ? p[0] | p[1] << 8 | p[2] << 16 | (u32)p[3] << 24 :
+        (*sys_rdl)(addr);
+}
+
 /****************************************************************************
 REMARKS:
 Handles any pending asynchronous interrupts.
@@ -94,6 +166,7 @@ void X86EMU_exec(void)
     u8 op1;
 
     M.x86.intr = 0;
+    x86emu_flush_code_page();
     DB(x86emu_end_instr();)
 
     for (;;) {
@@ -119,7 +192,7 @@ DB(             if (M.x86.R_SP != 0) {
                 x86emu_intr_handle();
             }
         }
-        op1 = (*sys_rdb)(((u32)M.x86.R_CS << 4) + (M.x86.R_IP++));
+        op1 = fetch_code_byte(((u32)M.x86.R_CS << 4) + (M.x86.R_IP++));
         (*x86emu_optab[op1])(op1);
         //if (M.x86.debug & DEBUG_EXIT) {
         //    M.x86.debug &= ~DEBUG_EXIT;
@@ -158,7 +231,7 @@ void fetch_decode_modrm(
 
 DB( if (CHECK_IP_FETCH())
         x86emu_check_ip_access();)
-    fetched = (*sys_rdb)(((u32)M.x86.R_CS << 4) + (M.x86.R_IP++));
+    fetched = fetch_code_byte(((u32)M.x86.R_CS << 4) + (M.x86.R_IP++));
     INC_DECODED_INST_LEN(1);
     *mod  = (fetched >> 6) & 0x03;
     *regh = (fetched >> 3) & 0x07;
@@ -181,7 +254,7 @@ u8 fetch_byte_imm(void)
 
 DB( if (CHECK_IP_FETCH())
         x86emu_check_ip_access();)
-    fetched = (*sys_rdb)(((u32)M.x86.R_CS << 4) + (M.x86.R_IP++));
+    fetched = fetch_code_byte(((u32)M.x86.R_CS << 4) + (M.x86.R_IP++));
     INC_DECODED_INST_LEN(1);
     return fetched;
 }
@@ -202,7 +275,7 @@ u16 fetch_word_imm(void)
 
 DB( if (CHECK_IP_FETCH())
         x86emu_check_ip_access();)
-    fetched = (*sys_rdw)(((u32)M.x86.R_CS << 4) + (M.x86.R_IP));
+    fetched = fetch_code_word(((u32)M.x86.R_CS << 4) + (M.x86.R_IP));
     M.x86.R_IP += 2;
     INC_DECODED_INST_LEN(2);
     return fetched;
@@ -224,7 +297,7 @@ u32 fetch_long_imm(void)
 
 DB( if (CHECK_IP_FETCH())
         x86emu_check_ip_access();)
-    fetched = (*sys_rdl)(((u32)M.x86.R_CS << 4) + (M.x86.R_IP));
+    fetched = fetch_code_long(((u32)M.x86.R_CS << 4) + (M.x86.R_IP));
     M.x86.R_IP += 4;
     INC_DECODED_INST_LEN(4);
     return fetched;
@@ -548,6 +621,141 @@ void store_data_long_abs(
     (*sys_wrl)(((u32)segment << 4) + offset, val);
 }
 
+/****************************************************************************
+PARAMETERS:
+addr    - Emulator memory address of a string element
+offset  - Offset of the element in its segment
+size    - Size of the elements in bytes
+
+RETURNS:
+Number of elements starting at addr that lie in its page and before the
+offset wraps around.
+****************************************************************************/
+static u32 string_room(
+    u32 addr,
+    u16 offset,
+    int size)
+{
+    u32 page_left = X86EMU_PAGE_SIZE - (addr & (X86EMU_PAGE_SIZE - 1));
+    u32 seg_left = 0x10000 - offset;
+
+    return (page_left < seg_left ? page_left : seg_left) / size;
+}
+
+/****************************************************************************
+PARAMETERS:
+size    - Size of the elements in bytes
+count   - Number of elements to move
+
+RETURNS:
+Number of elements moved.
+
+REMARKS:
+Fast path for REP MOVS with the direction flag clear. Moves the elements at
+SI in the data segment to ES:DI a page at a time for as long as both are in
+plain memory, and advances SI and DI past them. The caller moves the rest of
+the elements one by one.
+****************************************************************************/
+u32 x86emu_movs_fast(
+    int size,
+    u32 count)
+{
+    u32 done = 0;
+
+#ifdef DEBUG
+    if (CHECK_DATA_ACCESS())
+        return 0;
+#endif
+    while (done < count && sys_page) {
+        u32 src = (get_data_segment() << 4) + M.x86.R_SI;
+        u32 dst = ((u32)M.x86.R_ES << 4) + M.x86.R_DI;
+        u32 n = count - done;
+        u32 len, i;
+        u8 *s, *d;
+
+        if (n > string_room(src, M.x86.R_SI, size))
+            n = string_room(src, M.x86.R_SI, size);
+        if (n > string_room(dst, M.x86.R_DI, size))
+            n = string_room(dst, M.x86.R_DI, size);
+        if (n == 0)
+            break;
+        s = (*sys_page)(src);
+        d = (*sys_page)(dst);
+        if (s == NULL || d == NULL)
+            break;
+        s += src & (X86EMU_PAGE_SIZE - 1);
+        d += dst & (X86EMU_PAGE_SIZE - 1);
+
+        len = n * size;
+        if (d <= s || d >= s + len) {
+            memmove(d, s, len);
+        } else {
+            /* The destination overlaps the source further on, repeat
+               the elements like copying them one by one does. */
+            for (i = 0; i < len; i += size)
+                memmove(d + i, s + i, size);
+        }
+        M.x86.R_SI += len;
+        M.x86.R_DI += len;
+        done += n;
+    }
+    return done;
+}
+
+/****************************************************************************
+PARAMETERS:
+size    - Size of the elements in bytes
+val     - Value to store
+count   - Number of elements to store
+
+RETURNS:
+Number of elements stored.
+
+REMARKS:
+Fast path for REP STOS with the direction flag clear. Fills ES:DI a page at
+a time for as long as it is in plain memory, and advances DI past the
+elements stored. The caller stores the rest of the elements one by one.
+****************************************************************************/
+u32 x86emu_stos_fast(
+    int size,
+    u32 val,
+    u32 count)
+{
+    u8 pattern[4] = { val, val >> 8, val >> 16, val >> 24 };
+    u32 done = 0;
+
+#ifdef DEBUG
+    if (CHECK_DATA_ACCESS())
+        return 0;
+#endif
+    while (done < count && sys_page) {
+        u32 dst = ((u32)M.x86.R_ES << 4) + M.x86.R_DI;
+        u32 n = count - done;
+        u32 len, i;
+        u8 *d;
+
+        if (n > string_room(dst, M.x86.R_DI, size))
+            n = string_room(dst, M.x86.R_DI, size);
+        if (n == 0)
+            break;
+        d = (*sys_page)(dst);
+        if (d == NULL)
+            break;
+        d += dst & (X86EMU_PAGE_SIZE - 1);
+
+        len = n * size;
+        if (size == 1) {
+            memset(d, val, len);
+        } else {
+            for (i = 0; i < len; i += size)
+                memcpy(d + i, pattern, size);
+        }
+        M.x86.R_DI += len;
+        done += n;
+    }
+    return done;
+}
+
 /****************************************************************************
 PARAMETERS:
 reg - Register to decode
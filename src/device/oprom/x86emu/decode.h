@@ -72,6 +72,9 @@ void    store_data_word (uint offset, u16 val);
 void    store_data_word_abs (uint segment, uint offset, u16 val);
 void    store_data_long (uint offset, u32 val);
 void    store_data_long_abs (uint segment, uint offset, u32 val);
+u32     x86emu_movs_fast (int size, u32 count);
+u32     x86emu_stos_fast (int size, u32 val, u32 count);
+void    x86emu_flush_code_page (void);
 u8* 	decode_rm_byte_register(int reg);
 u16* 	decode_rm_word_register(int reg);
 u32* 	decode_rm_long_register(int reg);
@@ -496,8 +496,7 @@ Handles opcode 0x0f. Escape for two-byte opcode (286 or better)
 ****************************************************************************/
 static void x86emuOp_two_byte(u8 X86EMU_UNUSED(op1))
 {
-    u8 op2 = (*sys_rdb)(((u32)M.x86.R_CS << 4) + (M.x86.R_IP++));
-    INC_DECODED_INST_LEN(1);
+    u8 op2 = fetch_byte_imm();
     (*x86emu_optab2[op2])(op2);
 }
 
@@ -2538,6 +2537,8 @@ static void x86emuOp_movs_byte(u8 X86EMU_UNUSED(op1))
             M.x86.R_ECX = 0;
         M.x86.mode &= ~(SYSMODE_PREFIX_REPE | SYSMODE_PREFIX_REPNE);
     }
+    if (inc > 0 && count > 1)
+        count -= x86emu_movs_fast(inc, count);
     while (count--) {
         val = fetch_data_byte(M.x86.R_SI);
         store_data_byte_abs(M.x86.R_ES, M.x86.R_DI, val);
@@ -2585,6 +2586,8 @@ static void x86emuOp_movs_word(u8 X86EMU_UNUSED(op1))
             M.x86.R_ECX = 0;
         M.x86.mode &= ~(SYSMODE_PREFIX_REPE | SYSMODE_PREFIX_REPNE);
     }
+    if (inc > 0 && count > 1)
+        count -= x86emu_movs_fast(inc, count);
     while (count--) {
         if (M.x86.mode & SYSMODE_PREFIX_DATA) {
             val = fetch_data_long(M.x86.R_SI);
@@ -2775,6 +2778,12 @@ static void x86emuOp_stos_byte(u8 X86EMU_UNUSED(op1))
     if (M.x86.mode & (SYSMODE_PREFIX_REPE | SYSMODE_PREFIX_REPNE)) {
         /* don't care whether REPE or REPNE */
         /* move them until (E)CX is ZERO. */
+        if (inc > 0) {
+            if (M.x86.mode & SYSMODE_32BIT_REP)
+                M.x86.R_ECX -= x86emu_stos_fast(1, M.x86.R_AL, M.x86.R_ECX);
+            else
+                M.x86.R_CX -= x86emu_stos_fast(1, M.x86.R_AL, M.x86.R_CX);
+        }
         while (((M.x86.mode & SYSMODE_32BIT_REP) ? M.x86.R_ECX : M.x86.R_CX) != 0) {
             store_data_byte_abs(M.x86.R_ES, M.x86.R_DI, M.x86.R_AL);
             if (M.x86.mode & SYSMODE_32BIT_REP)
@@ -2828,6 +2837,8 @@ static void x86emuOp_stos_word(u8 X86EMU_UNUSED(op1))
             M.x86.R_ECX = 0;
         M.x86.mode &= ~(SYSMODE_PREFIX_REPE | SYSMODE_PREFIX_REPNE);
     }
+    if (inc > 0 && count > 1)
+        count -= x86emu_stos_fast(inc, M.x86.R_EAX, count);
     while (count--) {
         if (M.x86.mode & SYSMODE_PREFIX_DATA) {
             store_data_long_abs(M.x86.R_ES, M.x86.R_DI, M.x86.R_EAX);
@@ -45,6 +45,7 @@
 #include <x86emu/regs.h>
 #include <device/oprom/include/io.h>
 #include "debug.h"
+#include "decode.h"
 #include "prim_ops.h"
 
 #ifdef IN_MODULE
@@ -204,6 +205,30 @@ void X86API wrl(u32 addr, u32 val)
 
 }
 
+/****************************************************************************
+PARAMETERS:
+addr	- Emulator memory address
+
+RETURNS:
+Pointer to the start of the page containing addr, NULL if it is out of range.
+
+REMARKS:
+Page lookup for the default memory functions, all of emulator memory is
+plain memory for them.
+****************************************************************************/
+u8 * X86API mem_page(u32 addr)
+{
+	addr &= ~(X86EMU_PAGE_SIZE - 1);
+
+	DB(if (DEBUG_MEM_TRACE())
+	   return NULL;)
+	if (M.mem_size < X86EMU_PAGE_SIZE ||
+	    addr > M.mem_size - X86EMU_PAGE_SIZE)
+		return NULL;
+
+	return (u8 *) (M.mem_base + addr);
+}
+
 /****************************************************************************
 PARAMETERS:
 addr	- PIO address to read
@@ -303,6 +328,7 @@ u32(X86APIP sys_rdl) (u32 addr) = rdl;
 void (X86APIP sys_wrb) (u32 addr, u8 val) = wrb;
 void (X86APIP sys_wrw) (u32 addr, u16 val) = wrw;
 void (X86APIP sys_wrl) (u32 addr, u32 val) = wrl;
+u8 *(X86APIP sys_page) (u32 addr) = mem_page;
 u8(X86APIP sys_inb) (X86EMU_pioAddr addr) = p_inb;
 u16(X86APIP sys_inw) (X86EMU_pioAddr addr) = p_inw;
 u32(X86APIP sys_inl) (X86EMU_pioAddr addr) = p_inl;
@@ -329,6 +355,8 @@ void X86EMU_setupMemFuncs(X86EMU_memFuncs * funcs)
 	sys_wrb = funcs->wrb;
 	sys_wrw = funcs->wrw;
 	sys_wrl = funcs->wrl;
+	sys_page = funcs->page;
+	x86emu_flush_code_page();
 }
 
 /****************************************************************************
@@ -403,4 +431,5 @@ void X86EMU_setMemBase(void *base, size_t size)
 {
 	M.mem_base = (unsigned long) base;
 	M.mem_size = size;
+	x86emu_flush_code_page();
 }
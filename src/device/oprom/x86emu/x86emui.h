@@ -86,6 +86,7 @@ extern u32 	(X86APIP sys_rdl)(u32 addr);
 extern void (X86APIP sys_wrb)(u32 addr,u8 val);
 extern void (X86APIP sys_wrw)(u32 addr,u16 val);
 extern void (X86APIP sys_wrl)(u32 addr,u32 val);
+extern u8 *	(X86APIP sys_page)(u32 addr);
 
 extern u8  	(X86APIP sys_inb)(X86EMU_pioAddr addr);
 extern u16 	(X86APIP sys_inw)(X86EMU_pioAddr addr);
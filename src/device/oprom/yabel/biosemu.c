@@ -58,7 +58,8 @@ struct mono_time zero;
 
 static X86EMU_memFuncs my_mem_funcs = {
 	my_rdb, my_rdw, my_rdl,
-	my_wrb, my_wrw, my_wrl
+	my_wrb, my_wrw, my_wrl,
+	my_mem_page
 };
 
 static X86EMU_pioFuncs my_pio_funcs = {
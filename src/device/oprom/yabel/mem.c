@@ -480,6 +480,45 @@ my_wrl(u32 addr, u32 val)
 		out32le((void *) (M.mem_base + addr), val);
 	}
 }
+
+//return pointer to the memory behind a page, if the functions above treat
+//it as plain memory, see X86EMU_memFuncs
+u8 *
+my_mem_page(u32 addr)
+{
+	unsigned long page = addr & ~(X86EMU_PAGE_SIZE - 1);
+	unsigned long translated_page;
+	translate_address_t ta;
+	int i;
+
+	// the BDA timer is updated on reads, legacy VGA memory needs byte
+	// accesses
+	if ((page == 0) || ((page >= 0xa0000) && (page < 0xc0000)))
+		return NULL;
+#if CONFIG_X86EMU_DEBUG
+	if (debug_flags & DEBUG_CHECK_VMEM_ACCESS)
+		return NULL;
+#endif
+	// the first translation that overlaps the page is used for all of it,
+	// it has to be RAM added by biosemu_add_special_memory()
+	for (i = 0; i <= taa_last_entry; i++) {
+		ta = translate_address_array[i];
+		if (!(ta.info & IORESOURCE_MEM) || (page > ta.address + ta.size)
+		    || (page + X86EMU_PAGE_SIZE - 1 < ta.address))
+			continue;
+		if ((ta.info != (IORESOURCE_FIXED | IORESOURCE_MEM))
+		    || (ta.bus != 0) || (ta.devfn != 0)
+		    || (page < ta.address)
+		    || (page + X86EMU_PAGE_SIZE > ta.address + ta.size))
+			return NULL;
+		translated_page = page + ta.address_offset;
+		return (u8 *) translated_page;
+	}
+	if (page + X86EMU_PAGE_SIZE > M.mem_size)
+		return NULL;
+	/* virtual memory */
+	return (u8 *) (M.mem_base + page);
+}
 #else
 u8
 my_rdb(u32 addr)
@@ -516,4 +555,13 @@ my_wrl(u32 addr, u32 val)
 {
 	wrl(addr, val);
 }
+
+u8 *
+my_mem_page(u32 addr)
+{
+	// legacy VGA memory needs byte accesses
+	if ((addr >= 0xa0000) && (addr < 0xc0000))
+		return NULL;
+	return mem_page(addr);
+}
 #endif
@@ -54,4 +54,7 @@ void my_wrw(u32 addr, u16 val);
 //write long to memory
 void my_wrl(u32 addr, u32 val);
 
+//return pointer to a page of plain memory, or NULL
+u8 *my_mem_page(u32 addr);
+
 #endif
@@ -758,7 +758,8 @@ void vbe_set_graphics(void)
 	decdata = malloc(sizeof(*decdata));
 	int ret = 0;
 	DEBUG_PRINTF_VBE("Decompressing boot splash screen...\n");
-	ret = jpeg_decode(jpeg, framebuffer, 1024, 768, 16, decdata);
+	ret = jpeg_decode_scaled(jpeg, framebuffer, 1024, 768, 16,
+		le16_to_cpu(mode_info.vesa.bytes_per_scanline), 1, decdata);
 	DEBUG_PRINTF_VBE("returns %x\n", ret);
 #endif
 }
@@ -383,11 +383,50 @@ static void pciexp_tune_dev(device_t dev)
 		pciexp_enable_aspm(root, root_cap, dev, cap);
 }
 
+/*
+ * Behind a root or downstream port there is a point-to-point link with only
+ * device 0 on it. Unless ARI forwarding is enabled, the port doesn't forward
+ * configuration requests for the other device numbers and probing them only
+ * wastes time.
+ */
+static int pciexp_link_has_only_dev0(device_t bridge)
+{
+	unsigned int cap;
+	u16 flags;
+
+	if (!bridge || bridge->path.type != DEVICE_PATH_PCI)
+		return 0;
+
+	cap = pci_find_capability(bridge, PCI_CAP_ID_PCIE);
+	if (!cap)
+		return 0;
+
+	flags = pci_read_config16(bridge, cap + PCI_EXP_FLAGS);
+	switch ((flags & PCI_EXP_FLAGS_TYPE) >> 4) {
+	case PCI_EXP_TYPE_ROOT_PORT:
+	case PCI_EXP_TYPE_DOWNSTREAM:
+		break;
+	default:
+		return 0;
+	}
+
+	if ((flags & PCI_EXP_FLAGS_VERS) >= 2 &&
+	    (pci_read_config16(bridge, cap + PCI_EXP_DEVCTL2) &
+	     PCI_EXP_DEVCTL2_ARI))
+		return 0;
+
+	return 1;
+}
+
 void pciexp_scan_bus(struct bus *bus, unsigned int min_devfn,
 			     unsigned int max_devfn)
 {
 	device_t child;
 
+	if (pciexp_link_has_only_dev0(bus->dev) &&
+	    max_devfn > PCI_DEVFN(0, 7))
+		max_devfn = PCI_DEVFN(0, 7);
+
 	pci_scan_bus(bus, min_devfn, max_devfn);
 
 	for (child = bus->children; child; child = child->sibling) {
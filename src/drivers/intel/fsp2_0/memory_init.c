@@ -85,7 +85,7 @@ static void mrc_cache_update_tpm_hash(const uint8_t *data, size_t size)
 		return;
 	}
 
-	printk(BIOS_INFO, "MRC: TPM MRC hash updated successfully.\n");
+	printk(BIOS_INFO, "MRC: TPM MRC hash is up to date.\n");
 }
 
 static void save_memory_training_data(bool s3wake, uint32_t fsp_version)
@@ -17,6 +17,8 @@
 #define _X86_MP_H_
 
 #include <arch/smp/atomic.h>
+#include <commonlib/mp_timing_serialized.h>
+#include <cpu/x86/msr.h>
 #include <cpu/x86/smm.h>
 
 #define CACHELINE_SIZE 64
@@ -57,6 +59,13 @@ struct mp_ops {
 	 * can load the microcode in parallel.
 	 */
 	void (*get_microcode_info)(const void **microcode, int *parallel);
+	/*
+	 * Optionally record MSR writes for the APs with mp_add_ap_msr(). The
+	 * APs perform them in parallel right after loading microcode and
+	 * before running any C code, so CPU drivers need not program MSRs
+	 * that hold the same value on every CPU in mp_initialize_cpu().
+	 */
+	void (*add_ap_msrs)(void);
 	/*
 	 * Optionally provide a function which adjusts the APIC id
 	 * map to CPU number. By default the CPU number and APIC id
@@ -113,17 +122,25 @@ struct mp_ops {
  * 2. get_cpu_count()
  * 3. get_smm_info()
  * 4. get_microcode_info()
- * 5. adjust_cpu_apic_entry() for each number of get_cpu_count()
- * 6. adjust_smm_params(is_perm = 0)
- * 7. adjust_smm_params(is_perm = 1)
- * 8. pre_mp_smm_init()
- * 9. per_cpu_smm_trigger() in parallel for all cpus which calls
+ * 5. add_ap_msrs()
+ * 6. adjust_cpu_apic_entry() for each number of get_cpu_count()
+ * 7. adjust_smm_params(is_perm = 0)
+ * 8. adjust_smm_params(is_perm = 1)
+ * 9. pre_mp_smm_init()
+ * 10. per_cpu_smm_trigger() in parallel for all cpus which calls
  *    relocation_handler() in SMM.
- * 10. mp_initialize_cpu() for each cpu
- * 11. post_mp_init()
+ * 11. mp_initialize_cpu() for each cpu
+ * 12. post_mp_init()
  */
 int mp_init_with_smm(struct bus *cpu_bus, const struct mp_ops *mp_ops);
 
+/*
+ * Record an MSR write for the APs to perform on startup. Writes are done in
+ * the order they are added, after the BSP's MTRRs have been mirrored. Only
+ * valid from the add_ap_msrs() callback. Returns < 0 if the table is full.
+ */
+int mp_add_ap_msr(unsigned int index, msr_t msr);
+
 
 /*
  * After APs are up and PARALLEL_MP_AP_WORK is enabled one can issue work
@@ -21,6 +21,8 @@
  * is exposed so that a memranges can be used on the stack if needed. */
 struct memranges {
 	struct range_entry *entries;
+	/* Balanced search tree over the same entries (MEMRANGE_TREE). */
+	struct range_entry *root;
 	/* Coreboot doesn't have a free() function. Therefore, keep a cache of
 	 * free'd entries.  */
 	struct range_entry *free_list;
@@ -35,6 +37,9 @@ struct range_entry {
 	resource_t end;
 	unsigned long tag;
 	struct range_entry *next;
+	struct range_entry *left;
+	struct range_entry *right;
+	int height;
 };
 
 /* Initialize a range_entry with inclusive beginning address and exclusive
@@ -47,6 +52,9 @@ static inline void range_entry_init(struct range_entry *re,
 	re->end = excl_end - 1;
 	re->tag = tag;
 	re->next = NULL;
+	re->left = NULL;
+	re->right = NULL;
+	re->height = 0;
 }
 
 /* Return inclusive base address of memory range. */
@@ -72,6 +80,8 @@ static inline unsigned long range_entry_tag(const struct range_entry *r)
 	return r->tag;
 }
 
+/* Neighbors that end up with the same tag aren't merged, use
+ * memranges_update_tag() for that. */
 static inline void range_entry_update_tag(struct range_entry *r,
 					  unsigned long new_tag)
 {
@@ -143,6 +153,10 @@ void memranges_insert(struct memranges *ranges,
 void memranges_update_tag(struct memranges *ranges, unsigned long old_tag,
 			  unsigned long new_tag);
 
+/* Returns the entry covering addr. NULL if addr isn't covered. */
+struct range_entry *memranges_find_entry(struct memranges *ranges,
+					 resource_t addr);
+
 /* Returns next entry after the provided entry. NULL if r is last. */
 struct range_entry *memranges_next_entry(struct memranges *ranges,
 					 const struct range_entry *r);
@@ -43,7 +43,10 @@ int region_file_init(struct region_file *f, const struct region_device *p);
  */
 int region_file_data(const struct region_file *f, struct region_device *rdev);
 
-/* Update region file with latest data. Returns < 0 on error, 0 on success. */
+/*
+ * Update region file with latest data. Nothing is written if the latest data
+ * already matches. Returns < 0 on error, 0 on success.
+ */
 int region_file_update_data(struct region_file *f, const void *buf,
 				size_t size);
 
@@ -37,6 +37,27 @@ void stage_cache_external_region(void **base, size_t *size);
 struct stage_cache {
 	uint64_t load_addr;
 	uint64_t entry_addr;
+	/* CBFS_COMPRESS_* of the cached image. */
+	uint32_t compression;
+	/* Size of the cached image and of the stage once restored. */
+	uint32_t size;
+	uint32_t load_size;
+	/* Checksum of the cached image. */
+	uint32_t checksum;
 };
 
+/*
+ * Helpers for the stage cache backends. stage_cache_pack() fills in meta for
+ * the stage and writes the cached image to dst. With dst NULL only meta is
+ * filled in so the image can be allocated with the size returned. scratch
+ * holds LZ4F_COMPRESS_SCRATCH_SIZE bytes, or is NULL to store the stage as
+ * is. Both calls need the same scratch setting. stage_cache_unpack()
+ * verifies the image and restores the stage from it. It returns 0 on
+ * success.
+ */
+size_t stage_cache_pack(struct stage_cache *meta, const struct prog *stage,
+			void *dst, void *scratch);
+int stage_cache_unpack(const struct stage_cache *meta, const void *c,
+		       size_t size, struct prog *stage);
+
 #endif /* _STAGE_CACHE_H_ */
@@ -113,17 +113,12 @@ int bootmem_region_targets_usable_ram(uint64_t start, uint64_t size)
 	const struct range_entry *r;
 	uint64_t end = start + size;
 
-	memranges_each_entry(r, &bootmem) {
-		/* All further bootmem entries are beyond this range. */
-		if (end <= range_entry_base(r))
-			break;
-
-		if (start >= range_entry_base(r) && end <= range_entry_end(r)) {
-			if (range_entry_tag(r) == LB_MEM_RAM)
-				return 1;
-		}
-	}
-	return 0;
+	/* Only the entry covering start can cover the whole region. */
+	r = memranges_find_entry(&bootmem, start);
+	if (r == NULL || end > range_entry_end(r))
+		return 0;
+
+	return range_entry_tag(r) == LB_MEM_RAM;
 }
 
 void *bootmem_allocate_buffer(size_t size)
@@ -15,35 +15,65 @@
 
 #include <arch/early_variables.h>
 #include <cbmem.h>
+#include <commonlib/cbfs_serialized.h>
+#include <commonlib/compression.h>
+#include <console/console.h>
 #include <stage_cache.h>
-#include <string.h>
 
 /* Stage cache uses cbmem. */
+
+/* The compression scratch memory is a temporary entry. It's removed again
+ * right away, which only works as long as it's the last entry. */
+static void *scratch_add(const struct cbmem_entry **e)
+{
+	if (!IS_ENABLED(CONFIG_STAGE_CACHE_LZ4))
+		return NULL;
+
+	*e = cbmem_entry_add(CBMEM_ID_STAGEx_SCRATCH,
+			     LZ4F_COMPRESS_SCRATCH_SIZE);
+	if (*e == NULL)
+		return NULL;
+
+	return cbmem_entry_start(*e);
+}
+
+static void scratch_remove(const struct cbmem_entry *e)
+{
+	if (e != NULL && cbmem_entry_remove(e))
+		printk(BIOS_DEBUG, "Could not remove stage cache scratch.\n");
+}
+
 void stage_cache_add(int stage_id, const struct prog *stage)
 {
 	struct stage_cache *meta;
+	const struct cbmem_entry *e = NULL;
+	void *scratch;
 	void *c;
 
 	meta = cbmem_add(CBMEM_ID_STAGEx_META + stage_id, sizeof(*meta));
 	if (meta == NULL)
 		return;
-	meta->load_addr = (uintptr_t)prog_start(stage);
-	meta->entry_addr = (uintptr_t)prog_entry(stage);
 
-	c = cbmem_add(CBMEM_ID_STAGEx_CACHE + stage_id, prog_size(stage));
+	scratch = scratch_add(&e);
+	stage_cache_pack(meta, stage, NULL, scratch);
+	scratch_remove(e);
+
+	c = cbmem_add(CBMEM_ID_STAGEx_CACHE + stage_id, meta->size);
 	if (c == NULL)
 		return;
 
-	memcpy(c, prog_start(stage), prog_size(stage));
+	e = NULL;
+	scratch = NULL;
+	if (meta->compression != CBFS_COMPRESS_NONE)
+		scratch = scratch_add(&e);
+	stage_cache_pack(meta, stage, c, scratch);
+	scratch_remove(e);
 }
 
 void stage_cache_load_stage(int stage_id, struct prog *stage)
 {
 	struct stage_cache *meta;
 	const struct cbmem_entry *e;
-	void *c;
-	size_t size;
-	void *load_addr;
 
 	prog_set_entry(stage, NULL, NULL);
 
@@ -56,12 +86,6 @@ void stage_cache_load_stage(int stage_id, struct prog *stage)
 	if (e == NULL)
 		return;
 
-	c = cbmem_entry_start(e);
-	size = cbmem_entry_size(e);
-	load_addr = (void *)(uintptr_t)meta->load_addr;
-
-	memcpy(load_addr, c, size);
-
-	prog_set_area(stage, load_addr, size);
-	prog_set_entry(stage, (void *)(uintptr_t)meta->entry_addr, NULL);
+	stage_cache_unpack(meta, cbmem_entry_start(e), cbmem_entry_size(e),
+			   stage);
 }
@@ -39,6 +39,9 @@
 #include <boot/coreboot_tables.h>
 #include <vbe.h>
 
+/* The decoded EDID is only printed with CONFIG_DEBUG_EDID. */
+#define EDID_SPEW (IS_ENABLED(CONFIG_DEBUG_EDID) ? BIOS_SPEW : BIOS_NEVER)
+
 struct edid_context {
 	int claims_one_point_oh;
 	int claims_one_point_two;
@@ -155,9 +158,9 @@ detailed_cvt_descriptor(unsigned char *x, int first)
 	reduced	= (x[2] & 0x01);
 
 	if (!valid) {
-		printk(BIOS_SPEW, "    (broken)\n");
+		printk(EDID_SPEW, "    (broken)\n");
 	} else {
-		printk(BIOS_SPEW,
+		printk(EDID_SPEW,
 			"    %dx%d @ ( %s%s%s%s%s) Hz (%s%s preferred)\n",
 		       width, height,
 		       fifty ? "50 " : "",
@@ -208,10 +211,10 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 	struct edid *out = &tmp_edid;
 	int i;
 #if 1
-	printk(BIOS_SPEW, "Hex of detail: ");
+	printk(EDID_SPEW, "Hex of detail: ");
 	for (i = 0; i < 18; i++)
-		printk(BIOS_SPEW, "%02x", x[i]);
-	printk(BIOS_SPEW, "\n");
+		printk(EDID_SPEW, "%02x", x[i]);
+	printk(EDID_SPEW, "\n");
 #endif
 
 	/* Result might already have some valid fields like mode_is_supported */
@@ -221,14 +224,14 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 		/* Monitor descriptor block, not detailed timing descriptor. */
 		if (x[2] != 0) {
 			/* 1.3, 3.10.3 */
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"Monitor descriptor block has byte 2 nonzero (0x%02x)\n",
 			       x[2]);
 			c->has_valid_descriptor_pad = 0;
 		}
 		if (x[3] != 0xfd && x[4] != 0x00) {
 			/* 1.3, 3.10.3 */
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"Monitor descriptor block has byte 4 nonzero (0x%02x)\n",
 			       x[4]);
 			c->has_valid_descriptor_pad = 0;
@@ -242,25 +245,25 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 			 * 0x0f seems to be common in laptop panels.
 			 * 0x0e is used by EPI: http://www.epi-standard.org/
 			 */
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"Manufacturer-specified data, tag %d\n", x[3]);
 			return 1;
 		}
 		switch (x[3]) {
 		case 0x10:
-			printk(BIOS_SPEW, "Dummy block\n");
+			printk(EDID_SPEW, "Dummy block\n");
 			for (i = 5; i < 18; i++)
 				if (x[i] != 0x00)
 					c->has_valid_dummy_block = 0;
 			return 1;
 		case 0xF7:
 			/* TODO */
-			printk(BIOS_SPEW, "Established timings III\n");
+			printk(EDID_SPEW, "Established timings III\n");
 			return 1;
 		case 0xF8:
 		{
 			int valid_cvt = 1; /* just this block */
-			printk(BIOS_SPEW, "CVT 3-byte code descriptor:\n");
+			printk(EDID_SPEW, "CVT 3-byte code descriptor:\n");
 			if (x[5] != 0x01) {
 				c->has_valid_cvt = 0;
 				return 0;
@@ -273,18 +276,18 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 		}
 		case 0xF9:
 			/* TODO */
-			printk(BIOS_SPEW, "Color management data\n");
+			printk(EDID_SPEW, "Color management data\n");
 			return 1;
 		case 0xFA:
 			/* TODO */
-			printk(BIOS_SPEW, "More standard timings\n");
+			printk(EDID_SPEW, "More standard timings\n");
 			return 1;
 		case 0xFB:
 			/* TODO */
-			printk(BIOS_SPEW, "Color point\n");
+			printk(EDID_SPEW, "Color point\n");
 			return 1;
 		case 0xFC:
-			printk(BIOS_SPEW, "Monitor name: %s\n",
+			printk(EDID_SPEW, "Monitor name: %s\n",
 			       extract_string(x + 5,
 					      &c->has_valid_string_termination,
 					      13));
@@ -347,29 +350,29 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 				c->has_valid_range_descriptor = 0;
 			if (x[7] + h_min_offset > x[8] + h_max_offset)
 				c->has_valid_range_descriptor = 0;
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"Monitor ranges (%s): %d-%dHz V, %d-%dkHz H",
 			       extra_info.range_class,
 			       x[5] + v_min_offset, x[6] + v_max_offset,
 			       x[7] + h_min_offset, x[8] + h_max_offset);
 			if (x[9])
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					", max dotclock %dMHz\n", x[9] * 10);
 			else {
 				if (c->claims_one_point_four)
 					c->has_valid_max_dotclock = 0;
-				printk(BIOS_SPEW, "\n");
+				printk(EDID_SPEW, "\n");
 			}
 
 			if (is_cvt) {
 				int max_h_pixels = 0;
 
-				printk(BIOS_SPEW, "CVT version %d.%d\n",
+				printk(EDID_SPEW, "CVT version %d.%d\n",
 					x[11] & 0xf0 >> 4, x[11] & 0x0f);
 
 				if (x[12] & 0xfc) {
 					int raw_offset = (x[12] & 0xfc) >> 2;
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 						"Real max dotclock: %dKHz\n",
 					       (x[9] * 10000)
 						- (raw_offset * 250));
@@ -382,11 +385,11 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 				max_h_pixels |= x[13];
 				max_h_pixels *= 8;
 				if (max_h_pixels)
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 					     "Max active pixels per line: %d\n",
 					     max_h_pixels);
 
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 				    "Supported aspect ratios: %s %s %s %s %s\n",
 				     x[14] & 0x80 ? "4:3" : "",
 				     x[14] & 0x40 ? "16:9" : "",
@@ -396,53 +399,53 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 				if (x[14] & 0x07)
 					c->has_valid_range_descriptor = 0;
 
-				printk(BIOS_SPEW, "Preferred aspect ratio: ");
+				printk(EDID_SPEW, "Preferred aspect ratio: ");
 				switch ((x[15] & 0xe0) >> 5) {
 				case 0x00:
-					printk(BIOS_SPEW, "4:3");
+					printk(EDID_SPEW, "4:3");
 					break;
 				case 0x01:
-					printk(BIOS_SPEW, "16:9");
+					printk(EDID_SPEW, "16:9");
 					break;
 				case 0x02:
-					printk(BIOS_SPEW, "16:10");
+					printk(EDID_SPEW, "16:10");
 					break;
 				case 0x03:
-					printk(BIOS_SPEW, "5:4");
+					printk(EDID_SPEW, "5:4");
 					break;
 				case 0x04:
-					printk(BIOS_SPEW, "15:9");
+					printk(EDID_SPEW, "15:9");
 					break;
 				default:
-					printk(BIOS_SPEW, "(broken)");
+					printk(EDID_SPEW, "(broken)");
 					break;
 				}
-				printk(BIOS_SPEW, "\n");
+				printk(EDID_SPEW, "\n");
 
 				if (x[15] & 0x04)
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 					    "Supports CVT standard blanking\n");
 				if (x[15] & 0x10)
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 					    "Supports CVT reduced blanking\n");
 
 				if (x[15] & 0x07)
 					c->has_valid_range_descriptor = 0;
 
 				if (x[16] & 0xf0) {
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 						"Supported display scaling:\n");
 					if (x[16] & 0x80)
-						printk(BIOS_SPEW,
+						printk(EDID_SPEW,
 						    "    Horizontal shrink\n");
 					if (x[16] & 0x40)
-						printk(BIOS_SPEW,
+						printk(EDID_SPEW,
 						    "    Horizontal stretch\n");
 					if (x[16] & 0x20)
-						printk(BIOS_SPEW,
+						printk(EDID_SPEW,
 						    "    Vertical shrink\n");
 					if (x[16] & 0x10)
-						printk(BIOS_SPEW,
+						printk(EDID_SPEW,
 						    "    Vertical stretch\n");
 				}
 
@@ -450,7 +453,7 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 					c->has_valid_range_descriptor = 0;
 
 				if (x[17])
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 					  "Preferred vertical refresh: %d Hz\n",
 					  x[17]);
 				else
@@ -470,17 +473,17 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 			 * slots, seems to be specified by SPWG:
 			 * http://www.spwg.org/
 			 */
-			printk(BIOS_SPEW, "ASCII string: %s\n",
+			printk(EDID_SPEW, "ASCII string: %s\n",
 			       extract_string(x + 5,
 			       &c->has_valid_string_termination, 13));
 			return 1;
 		case 0xFF:
-			printk(BIOS_SPEW, "Serial number: %s\n",
+			printk(EDID_SPEW, "Serial number: %s\n",
 			       extract_string(x + 5,
 			       &c->has_valid_string_termination, 13));
 			return 1;
 		default:
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"Unknown monitor description type %d\n",
 				x[3]);
 			return 0;
@@ -570,7 +573,7 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 		break;
 	}
 
-	printk(BIOS_SPEW,
+	printk(EDID_SPEW,
 		"Detailed mode (IN HEX): Clock %d KHz, %x mm x %x mm\n"
 	       "               %04x %04x %04x %04x hborder %x\n"
 	       "               %04x %04x %04x %04x vborder %x\n"
@@ -589,7 +592,7 @@ detailed_block(struct edid *result_edid, unsigned char *x, int in_extension,
 	       extra_info.stereo);
 
 	if (!c->did_detailed_timing) {
-		printk(BIOS_SPEW, "Did detailed timing\n");
+		printk(EDID_SPEW, "Did detailed timing\n");
 		c->did_detailed_timing = 1;
 		*result_edid = *out;
 	}
@@ -601,21 +604,21 @@ static int
 do_checksum(unsigned char *x)
 {
 	int valid = 0;
-	printk(BIOS_SPEW, "Checksum: 0x%hhx", x[0x7f]);
+	printk(EDID_SPEW, "Checksum: 0x%hhx", x[0x7f]);
 	{
 		unsigned char sum = 0;
 		int i;
 		for (i = 0; i < 128; i++)
 			sum += x[i];
 		if (sum) {
-			printk(BIOS_SPEW, " (should be 0x%hhx)",
+			printk(EDID_SPEW, " (should be 0x%hhx)",
 				(unsigned char)(x[0x7f] - sum));
 		} else {
 			valid = 1;
-			printk(BIOS_SPEW, " (valid)");
+			printk(EDID_SPEW, " (valid)");
 		}
 	}
-	printk(BIOS_SPEW, "\n");
+	printk(EDID_SPEW, "\n");
 	return valid;
 }
 
@@ -652,16 +655,16 @@ cea_audio_block(unsigned char *x)
 	int length = x[0] & 0x1f;
 
 	if (length % 3) {
-		printk(BIOS_SPEW, "Broken CEA audio block length %d\n", length);
+		printk(EDID_SPEW, "Broken CEA audio block length %d\n", length);
 		/* XXX non-conformant */
 		return;
 	}
 
 	for (i = 1; i < length; i += 3) {
 		format = (x[i] & 0x78) >> 3;
-		printk(BIOS_SPEW, "    %s, max channels %d\n",
+		printk(EDID_SPEW, "    %s, max channels %d\n",
 			audio_format(format), x[i] & 0x07);
-		printk(BIOS_SPEW,
+		printk(EDID_SPEW,
 			"    Supported sample rates (kHz):%s%s%s%s%s%s%s\n",
 		       (x[i+1] & 0x40) ? " 192" : "",
 		       (x[i+1] & 0x20) ? " 176.4" : "",
@@ -671,13 +674,13 @@ cea_audio_block(unsigned char *x)
 		       (x[i+1] & 0x02) ? " 44.1" : "",
 		       (x[i+1] & 0x01) ? " 32" : "");
 		if (format == 1) {
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"    Supported sample sizes (bits):%s%s%s\n",
 			       (x[2] & 0x04) ? " 24" : "",
 			       (x[2] & 0x02) ? " 20" : "",
 			       (x[2] & 0x01) ? " 16" : "");
 		} else if (format <= 8) {
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"    Maximum bit rate: %d kHz\n", x[2] * 8);
 		}
 	}
@@ -690,7 +693,7 @@ cea_video_block(unsigned char *x)
 	int length = x[0] & 0x1f;
 
 	for (i = 1; i < length; i++)
-		printk(BIOS_SPEW, "    VIC %02d %s\n", x[i] & 0x7f,
+		printk(EDID_SPEW, "    VIC %02d %s\n", x[i] & 0x7f,
 		       x[i] & 0x80 ? "(native)" : "");
 }
 
@@ -701,44 +704,44 @@ cea_hdmi_block(struct edid *out, unsigned char *x)
 
 	out->hdmi_monitor_detected = 1;
 
-	printk(BIOS_SPEW, " (HDMI)\n");
-	printk(BIOS_SPEW,
+	printk(EDID_SPEW, " (HDMI)\n");
+	printk(EDID_SPEW,
 	       "    Source physical address %d.%d.%d.%d\n",
 	       x[4] >> 4, x[4] & 0x0f, x[5] >> 4, x[5] & 0x0f);
 
 	if (length > 5) {
 		if (x[6] & 0x80)
-			printk(BIOS_SPEW, "    Supports_AI\n");
+			printk(EDID_SPEW, "    Supports_AI\n");
 		if (x[6] & 0x40)
-			printk(BIOS_SPEW, "    DC_48bit\n");
+			printk(EDID_SPEW, "    DC_48bit\n");
 		if (x[6] & 0x20)
-			printk(BIOS_SPEW, "    DC_36bit\n");
+			printk(EDID_SPEW, "    DC_36bit\n");
 		if (x[6] & 0x10)
-			printk(BIOS_SPEW, "    DC_30bit\n");
+			printk(EDID_SPEW, "    DC_30bit\n");
 		if (x[6] & 0x08)
-			printk(BIOS_SPEW, "    DC_Y444\n");
+			printk(EDID_SPEW, "    DC_Y444\n");
 		/* two reserved */
 		if (x[6] & 0x01)
-			printk(BIOS_SPEW, "    DVI_Dual\n");
+			printk(EDID_SPEW, "    DVI_Dual\n");
 	}
 
 	if (length > 6)
-		printk(BIOS_SPEW, "    Maximum TMDS clock: %dMHz\n", x[7] * 5);
+		printk(EDID_SPEW, "    Maximum TMDS clock: %dMHz\n", x[7] * 5);
 
 	/* XXX the walk here is really ugly, and needs to be length-checked */
 	if (length > 7) {
 		int b = 0;
 
 		if (x[8] & 0x80) {
-			printk(BIOS_SPEW, "    Video latency: %d\n", x[9 + b]);
-			printk(BIOS_SPEW, "    Audio latency: %d\n", x[10 + b]);
+			printk(EDID_SPEW, "    Video latency: %d\n", x[9 + b]);
+			printk(EDID_SPEW, "    Audio latency: %d\n", x[10 + b]);
 			b += 2;
 		}
 
 		if (x[8] & 0x40) {
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"    Interlaced video latency: %d\n", x[9 + b]);
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"    Interlaced audio latency: %d\n",
 				x[10 + b]);
 			b += 2;
@@ -747,16 +750,16 @@ cea_hdmi_block(struct edid *out, unsigned char *x)
 		if (x[8] & 0x20) {
 			int mask = 0, formats = 0;
 			int len_xx, len_3d;
-			printk(BIOS_SPEW, "    Extended HDMI video details:\n");
+			printk(EDID_SPEW, "    Extended HDMI video details:\n");
 			if (x[9 + b] & 0x80)
-				printk(BIOS_SPEW, "      3D present\n");
+				printk(EDID_SPEW, "      3D present\n");
 			if ((x[9 + b] & 0x60) == 0x20) {
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 				  "      All advertised VICs are 3D-capable\n");
 				formats = 1;
 			}
 			if ((x[9 + b] & 0x60) == 0x40) {
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"      3D-capable-VIC mask present\n");
 				formats = 1;
 				mask = 1;
@@ -765,13 +768,13 @@ cea_hdmi_block(struct edid *out, unsigned char *x)
 			case 0x00:
 				break;
 			case 0x08:
-				printk(BIOS_SPEW, "      Base EDID image size is aspect ratio\n");
+				printk(EDID_SPEW, "      Base EDID image size is aspect ratio\n");
 				break;
 			case 0x10:
-				printk(BIOS_SPEW, "      Base EDID image size is in units of 1cm\n");
+				printk(EDID_SPEW, "      Base EDID image size is in units of 1cm\n");
 				break;
 			case 0x18:
-				printk(BIOS_SPEW, "      Base EDID image size is in units of 5cm\n");
+				printk(EDID_SPEW, "      Base EDID image size is in units of 5cm\n");
 				break;
 			}
 			len_xx = (x[10 + b] & 0xe0) >> 5;
@@ -779,7 +782,7 @@ cea_hdmi_block(struct edid *out, unsigned char *x)
 			b += 2;
 
 			if (len_xx) {
-				printk(BIOS_SPEW, "      Skipping %d bytes that HDMI refuses to publicly"
+				printk(EDID_SPEW, "      Skipping %d bytes that HDMI refuses to publicly"
 				       " document\n", len_xx);
 				b += len_xx;
 			}
@@ -787,27 +790,27 @@ cea_hdmi_block(struct edid *out, unsigned char *x)
 			if (len_3d) {
 				if (formats) {
 					if (x[9 + b] & 0x01)
-						printk(BIOS_SPEW, "      Side-by-side 3D supported\n");
+						printk(EDID_SPEW, "      Side-by-side 3D supported\n");
 					if (x[10 + b] & 0x40)
-						printk(BIOS_SPEW, "      Top-and-bottom 3D supported\n");
+						printk(EDID_SPEW, "      Top-and-bottom 3D supported\n");
 					if (x[10 + b] & 0x01)
-						printk(BIOS_SPEW, "      Frame-packing 3D supported\n");
+						printk(EDID_SPEW, "      Frame-packing 3D supported\n");
 					b += 2;
 				}
 				if (mask) {
 					int i;
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 						"      3D VIC indices:");
 					/* worst bit ordering ever */
 					for (i = 0; i < 8; i++)
 						if (x[10 + b] & (1 << i))
-							printk(BIOS_SPEW,
+							printk(EDID_SPEW,
 								" %d", i);
 					for (i = 0; i < 8; i++)
 						if (x[9 + b] & (1 << i))
-							printk(BIOS_SPEW,
+							printk(EDID_SPEW,
 								" %d", i + 8);
-					printk(BIOS_SPEW, "\n");
+					printk(EDID_SPEW, "\n");
 					b += 2;
 				}
 
@@ -830,69 +833,69 @@ cea_block(struct edid *out, unsigned char *x)
 
 	switch ((x[0] & 0xe0) >> 5) {
 	case 0x01:
-		printk(BIOS_SPEW, "  Audio data block\n");
+		printk(EDID_SPEW, "  Audio data block\n");
 		cea_audio_block(x);
 		break;
 	case 0x02:
-		printk(BIOS_SPEW, "  Video data block\n");
+		printk(EDID_SPEW, "  Video data block\n");
 		cea_video_block(x);
 		break;
 	case 0x03:
 		/* yes really, endianness lols */
 		oui = (x[3] << 16) + (x[2] << 8) + x[1];
-		printk(BIOS_SPEW, "  Vendor-specific data block, OUI %06x",
+		printk(EDID_SPEW, "  Vendor-specific data block, OUI %06x",
 			oui);
 		if (oui == 0x000c03)
 			cea_hdmi_block(out, x);
 		else
-			printk(BIOS_SPEW, "\n");
+			printk(EDID_SPEW, "\n");
 		break;
 	case 0x04:
-		printk(BIOS_SPEW, "  Speaker allocation data block\n");
+		printk(EDID_SPEW, "  Speaker allocation data block\n");
 		break;
 	case 0x05:
-		printk(BIOS_SPEW, "  VESA DTC data block\n");
+		printk(EDID_SPEW, "  VESA DTC data block\n");
 		break;
 	case 0x07:
-		printk(BIOS_SPEW, "  Extended tag: ");
+		printk(EDID_SPEW, "  Extended tag: ");
 		switch (x[1]) {
 		case 0x00:
-			printk(BIOS_SPEW, "video capability data block\n");
+			printk(EDID_SPEW, "video capability data block\n");
 			break;
 		case 0x01:
-			printk(BIOS_SPEW, "vendor-specific video data block\n");
+			printk(EDID_SPEW, "vendor-specific video data block\n");
 			break;
 		case 0x02:
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 			  "VESA video display device information data block\n");
 			break;
 		case 0x03:
-			printk(BIOS_SPEW, "VESA video data block\n");
+			printk(EDID_SPEW, "VESA video data block\n");
 			break;
 		case 0x04:
-			printk(BIOS_SPEW, "HDMI video data block\n");
+			printk(EDID_SPEW, "HDMI video data block\n");
 			break;
 		case 0x05:
-			printk(BIOS_SPEW, "Colorimetry data block\n");
+			printk(EDID_SPEW, "Colorimetry data block\n");
 			break;
 		case 0x10:
-			printk(BIOS_SPEW, "CEA miscellaneous audio fields\n");
+			printk(EDID_SPEW, "CEA miscellaneous audio fields\n");
 			break;
 		case 0x11:
-			printk(BIOS_SPEW, "Vendor-specific audio data block\n");
+			printk(EDID_SPEW, "Vendor-specific audio data block\n");
 			break;
 		case 0x12:
-			printk(BIOS_SPEW, "HDMI audio data block\n");
+			printk(EDID_SPEW, "HDMI audio data block\n");
 			break;
 		default:
 			if (x[1] >= 6 && x[1] <= 15)
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"Reserved video block (%02x)\n", x[1]);
 			else if (x[1] >= 19 && x[1] <= 31)
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"Reserved audio block (%02x)\n", x[1]);
 			else
-				printk(BIOS_SPEW, "Unknown (%02x)\n", x[1]);
+				printk(EDID_SPEW, "Unknown (%02x)\n", x[1]);
 			break;
 		}
 		break;
@@ -900,7 +903,7 @@ cea_block(struct edid *out, unsigned char *x)
 	{
 		int tag = (*x & 0xe0) >> 5;
 		int length = *x & 0x1f;
-		printk(BIOS_SPEW,
+		printk(EDID_SPEW,
 			"  Unknown tag %d, length %d (raw %02x)\n",
 			tag, length, *x);
 		break;
@@ -925,12 +928,12 @@ parse_cea(struct edid *out, unsigned char *x, struct edid_context *c)
 				break;
 
 			if (version < 3)
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"%d 8-byte timing descriptors\n",
 					(offset - 4) / 8);
 			else if (version == 3) {
 				int i;
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"%d bytes of CEA data\n", offset - 4);
 				for (i = 4; i < offset; i += (x[i] & 0x1f) + 1)
 					cea_block(out, x + i);
@@ -938,18 +941,18 @@ parse_cea(struct edid *out, unsigned char *x, struct edid_context *c)
 
 			if (version >= 2) {
 				if (x[3] & 0x80)
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 					  "Underscans PC formats by default\n");
 				if (x[3] & 0x40)
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 						"Basic audio support\n");
 				if (x[3] & 0x20)
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 						"Supports YCbCr 4:4:4\n");
 				if (x[3] & 0x10)
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 						"Supports YCbCr 4:2:2\n");
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"%d native detailed modes\n",
 					x[3] & 0x0f);
 			}
@@ -969,44 +972,44 @@ parse_cea(struct edid *out, unsigned char *x, struct edid_context *c)
 static void
 extension_version(struct edid *out, unsigned char *x)
 {
-	printk(BIOS_SPEW, "Extension version: %d\n", x[1]);
+	printk(EDID_SPEW, "Extension version: %d\n", x[1]);
 }
 
 static int
 parse_extension(struct edid *out, unsigned char *x, struct edid_context *c)
 {
 	int conformant_extension = 0;
-	printk(BIOS_SPEW, "\n");
+	printk(EDID_SPEW, "\n");
 
 	switch (x[0]) {
 	case 0x02:
-		printk(BIOS_SPEW, "CEA extension block\n");
+		printk(EDID_SPEW, "CEA extension block\n");
 		extension_version(out, x);
 		conformant_extension = parse_cea(out, x, c);
 		break;
 	case 0x10:
-		printk(BIOS_SPEW, "VTB extension block\n");
+		printk(EDID_SPEW, "VTB extension block\n");
 		break;
 	case 0x40:
-		printk(BIOS_SPEW, "DI extension block\n");
+		printk(EDID_SPEW, "DI extension block\n");
 		break;
 	case 0x50:
-		printk(BIOS_SPEW, "LS extension block\n");
+		printk(EDID_SPEW, "LS extension block\n");
 		break;
 	case 0x60:
-		printk(BIOS_SPEW, "DPVL extension block\n");
+		printk(EDID_SPEW, "DPVL extension block\n");
 		break;
 	case 0xF0:
-		printk(BIOS_SPEW, "Block map\n");
+		printk(EDID_SPEW, "Block map\n");
 		break;
 	case 0xFF:
-		printk(BIOS_SPEW, "Manufacturer-specific extension block\n");
+		printk(EDID_SPEW, "Manufacturer-specific extension block\n");
 	default:
-		printk(BIOS_SPEW, "Unknown extension block\n");
+		printk(EDID_SPEW, "Unknown extension block\n");
 		break;
 	}
 
-	printk(BIOS_SPEW, "\n");
+	printk(EDID_SPEW, "\n");
 
 	return conformant_extension;
 }
@@ -1041,17 +1044,17 @@ static void print_subsection(const char *name, unsigned char *edid, int start,
 {
 	int i;
 
-	printk(BIOS_SPEW, "%s:", name);
+	printk(EDID_SPEW, "%s:", name);
 	for (i = strlen(name); i < 15; i++)
-		printk(BIOS_SPEW, " ");
+		printk(EDID_SPEW, " ");
 	for (i = start; i <= end; i++)
-		printk(BIOS_SPEW, " %02x", edid[i]);
-	printk(BIOS_SPEW, "\n");
+		printk(EDID_SPEW, " %02x", edid[i]);
+	printk(EDID_SPEW, "\n");
 }
 
 static void dump_breakdown(unsigned char *edid)
 {
-	printk(BIOS_SPEW, "Extracted contents:\n");
+	printk(EDID_SPEW, "Extracted contents:\n");
 	print_subsection("header", edid, 0, 7);
 	print_subsection("serial number", edid, 8, 17);
 	print_subsection("version", edid, 18, 19);
@@ -1065,7 +1068,7 @@ static void dump_breakdown(unsigned char *edid)
 	print_subsection("descriptor 4", edid, 108, 125);
 	print_subsection("extensions", edid, 126, 126);
 	print_subsection("checksum", edid, 127, 127);
-	printk(BIOS_SPEW, "\n");
+	printk(EDID_SPEW, "\n");
 }
 
 /*
@@ -1142,7 +1145,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 	memset(out, 0, sizeof(*out));
 
 	if (!edid || memcmp(edid, "\x00\xFF\xFF\xFF\xFF\xFF\xFF\x00", 8)) {
-		printk(BIOS_SPEW, "No header found\n");
+		printk(EDID_SPEW, "No header found\n");
 		return 1;
 	}
 
@@ -1153,7 +1156,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 	extra_info.serial = (unsigned int)(edid[0x0C] + (edid[0x0D] << 8)
 				     + (edid[0x0E] << 16) + (edid[0x0F] << 24));
 
-	printk(BIOS_SPEW, "Manufacturer: %s Model %x Serial Number %u\n",
+	printk(EDID_SPEW, "Manufacturer: %s Model %x Serial Number %u\n",
 	       extra_info.manuf_name,
 	       (unsigned short)(edid[0x0A] + (edid[0x0B] << 8)),
 	       (unsigned int)(edid[0x0C] + (edid[0x0D] << 8)
@@ -1165,7 +1168,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 		if (edid[0x11] > 0x0f) {
 			if (edid[0x10] == 0xff) {
 				c.has_valid_year = 1;
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"Made week %hhd of model year %hhd\n",
 					edid[0x10], edid[0x11]);
 				extra_info.week = edid[0x10];
@@ -1176,7 +1179,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 				 */
 				if (edid[0x11] + 90 <= 2013) {
 					c.has_valid_year = 1;
-					printk(BIOS_SPEW,
+					printk(EDID_SPEW,
 						"Made week %hhd of %d\n",
 					       edid[0x10], edid[0x11] + 1990);
 					extra_info.week = edid[0x10];
@@ -1186,13 +1189,13 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 		}
 	}
 
-	printk(BIOS_SPEW, "EDID version: %hhd.%hhd\n", edid[0x12], edid[0x13]);
+	printk(EDID_SPEW, "EDID version: %hhd.%hhd\n", edid[0x12], edid[0x13]);
 	extra_info.version[0] = edid[0x12];
 	extra_info.version[1] = edid[0x13];
 
 	if (edid[0x12] == 1) {
 		if (edid[0x13] > 4) {
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"Claims > 1.4, assuming 1.4 conformance\n");
 			edid[0x13] = 4;
 		}
@@ -1213,15 +1216,15 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 	if (edid[0x14] & 0x80) {
 		int conformance_mask;
 		analog = 0;
-		printk(BIOS_SPEW, "Digital display\n");
+		printk(EDID_SPEW, "Digital display\n");
 		if (c.claims_one_point_four) {
 			conformance_mask = 0;
 			if ((edid[0x14] & 0x70) == 0x00)
-				printk(BIOS_SPEW, "Color depth is undefined\n");
+				printk(EDID_SPEW, "Color depth is undefined\n");
 			else if ((edid[0x14] & 0x70) == 0x70)
 				c.nonconformant_digital_display = 1;
 			else
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"%d bits per primary color channel\n",
 				       ((edid[0x14] & 0x70) >> 3) + 4);
 			out->panel_bits_per_color = ((edid[0x14] & 0x70) >> 3)
@@ -1230,23 +1233,23 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 
 			switch (edid[0x14] & 0x0f) {
 			case 0x00:
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"Digital interface is not defined\n");
 				break;
 			case 0x01:
-				printk(BIOS_SPEW, "DVI interface\n");
+				printk(EDID_SPEW, "DVI interface\n");
 				break;
 			case 0x02:
-				printk(BIOS_SPEW, "HDMI-a interface\n");
+				printk(EDID_SPEW, "HDMI-a interface\n");
 				break;
 			case 0x03:
-				printk(BIOS_SPEW, "HDMI-b interface\n");
+				printk(EDID_SPEW, "HDMI-b interface\n");
 				break;
 			case 0x04:
-				printk(BIOS_SPEW, "MDDI interface\n");
+				printk(EDID_SPEW, "MDDI interface\n");
 				break;
 			case 0x05:
-				printk(BIOS_SPEW, "DisplayPort interface\n");
+				printk(EDID_SPEW, "DisplayPort interface\n");
 				break;
 			default:
 				c.nonconformant_digital_display = 1;
@@ -1256,7 +1259,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 		} else if (c.claims_one_point_two) {
 			conformance_mask = 0x7E;
 			if (edid[0x14] & 0x01)
-				printk(BIOS_SPEW, "DFP 1.x compatible TMDS\n");
+				printk(EDID_SPEW, "DFP 1.x compatible TMDS\n");
 		} else
 			conformance_mask = 0x7F;
 
@@ -1271,7 +1274,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 		extra_info.voltage = voltage;
 		extra_info.sync = sync;
 
-		printk(BIOS_SPEW, "Analog display, Input voltage level: %s V\n",
+		printk(EDID_SPEW, "Analog display, Input voltage level: %s V\n",
 		       voltage == 3 ? "0.7/0.7" :
 		       voltage == 2 ? "1.0/0.4" :
 		       voltage == 1 ? "0.714/0.286" :
@@ -1279,10 +1282,10 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 
 		if (c.claims_one_point_four) {
 			if (edid[0x14] & 0x10)
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"Blank-to-black setup/pedestal\n");
 			else
-				printk(BIOS_SPEW,
+				printk(EDID_SPEW,
 					"Blank level equals black level\n");
 		} else if (edid[0x14] & 0x10) {
 			/*
@@ -1291,10 +1294,10 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 			 * per appropriate Signal Level Standard".  Whatever
 			 * _that_ means.
 			 */
-			printk(BIOS_SPEW, "Configurable signal levels\n");
+			printk(EDID_SPEW, "Configurable signal levels\n");
 		}
 
-		printk(BIOS_SPEW, "Sync: %s%s%s%s\n",
+		printk(EDID_SPEW, "Sync: %s%s%s%s\n",
 			sync & 0x08 ? "Separate " : "",
 			sync & 0x04 ? "Composite " : "",
 			sync & 0x02 ? "SyncOnGreen " : "",
@@ -1303,92 +1306,92 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 
 
 	if (edid[0x15] && edid[0x16]) {
-		printk(BIOS_SPEW, "Maximum image size: %d cm x %d cm\n",
+		printk(EDID_SPEW, "Maximum image size: %d cm x %d cm\n",
 		       edid[0x15], edid[0x16]);
 	} else if (c.claims_one_point_four && (edid[0x15] || edid[0x16])) {
 		if (edid[0x15]) { /* edid[0x15] != 0 && edid[0x16] == 0 */
 			unsigned int ratio = 100000/(edid[0x15] + 99);
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"Aspect ratio is %u.%03u (landscape)\n",
 				ratio / 1000, ratio % 1000);
 		} else { /* edid[0x15] == 0 && edid[0x16] != 0 */
 			unsigned int ratio = 100000/(edid[0x16] + 99);
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"Aspect ratio is %u.%03u (portrait)\n",
 				ratio / 1000, ratio % 1000);
 		}
 	} else {
 		/* Either or both can be zero for 1.3 and before */
-		printk(BIOS_SPEW, "Image size is variable\n");
+		printk(EDID_SPEW, "Image size is variable\n");
 	}
 
 	if (edid[0x17] == 0xff) {
 		if (c.claims_one_point_four)
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"Gamma is defined in an extension block\n");
 		else
 			/* XXX Technically 1.3 doesn't say this... */
-			printk(BIOS_SPEW, "Gamma: 1.0\n");
+			printk(EDID_SPEW, "Gamma: 1.0\n");
 	} else
-		printk(BIOS_SPEW, "Gamma: %d%%\n", ((edid[0x17] + 100)));
-	printk(BIOS_SPEW, "Check DPMS levels\n");
+		printk(EDID_SPEW, "Gamma: %d%%\n", ((edid[0x17] + 100)));
+	printk(EDID_SPEW, "Check DPMS levels\n");
 	if (edid[0x18] & 0xE0) {
-		printk(BIOS_SPEW, "DPMS levels:");
+		printk(EDID_SPEW, "DPMS levels:");
 		if (edid[0x18] & 0x80)
-			printk(BIOS_SPEW, " Standby");
+			printk(EDID_SPEW, " Standby");
 		if (edid[0x18] & 0x40)
-			printk(BIOS_SPEW, " Suspend");
+			printk(EDID_SPEW, " Suspend");
 		if (edid[0x18] & 0x20)
-			printk(BIOS_SPEW, " Off");
-		printk(BIOS_SPEW, "\n");
+			printk(EDID_SPEW, " Off");
+		printk(EDID_SPEW, "\n");
 	}
 
 	/* FIXME: this is from 1.4 spec, check earlier */
 	if (analog) {
 		switch (edid[0x18] & 0x18) {
 		case 0x00:
-			printk(BIOS_SPEW, "Monochrome or grayscale display\n");
+			printk(EDID_SPEW, "Monochrome or grayscale display\n");
 			break;
 		case 0x08:
-			printk(BIOS_SPEW, "RGB color display\n");
+			printk(EDID_SPEW, "RGB color display\n");
 			break;
 		case 0x10:
-			printk(BIOS_SPEW, "Non-RGB color display\n");
+			printk(EDID_SPEW, "Non-RGB color display\n");
 			break;
 		case 0x18:
-			printk(BIOS_SPEW, "Undefined display color type\n");
+			printk(EDID_SPEW, "Undefined display color type\n");
 			break;
 		}
 	} else {
-		printk(BIOS_SPEW, "Supported color formats: RGB 4:4:4");
+		printk(EDID_SPEW, "Supported color formats: RGB 4:4:4");
 		if (edid[0x18] & 0x10)
-			printk(BIOS_SPEW, ", YCrCb 4:4:4");
+			printk(EDID_SPEW, ", YCrCb 4:4:4");
 		if (edid[0x18] & 0x08)
-			printk(BIOS_SPEW, ", YCrCb 4:2:2");
-		printk(BIOS_SPEW, "\n");
+			printk(EDID_SPEW, ", YCrCb 4:2:2");
+		printk(EDID_SPEW, "\n");
 	}
 
 	if (edid[0x18] & 0x04)
-		printk(BIOS_SPEW,
+		printk(EDID_SPEW,
 			"Default (sRGB) color space is primary color space\n");
 	if (edid[0x18] & 0x02) {
-		printk(BIOS_SPEW,
+		printk(EDID_SPEW,
 			"First detailed timing is preferred timing\n");
 		c.has_preferred_timing = 1;
 	}
 	if (edid[0x18] & 0x01)
-		printk(BIOS_SPEW,
+		printk(EDID_SPEW,
 			"Supports GTF timings within operating range\n");
 
 	/* XXX color section */
 
-	printk(BIOS_SPEW, "Established timings supported:\n");
+	printk(EDID_SPEW, "Established timings supported:\n");
 	/* it's not yet clear we want all this stuff in the edid struct.
 	 * Let's wait.
 	 */
 	for (i = 0; i < 17; i++) {
 		if (edid[0x23 + i / 8] & (1 << (7 - i % 8))) {
-			printk(BIOS_SPEW, "  %dx%d@%dHz\n",
+			printk(EDID_SPEW, "  %dx%d@%dHz\n",
 				established_timings[i].x,
 				established_timings[i].y,
 				established_timings[i].refresh);
@@ -1406,7 +1409,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 
 	}
 
-	printk(BIOS_SPEW, "Standard timings supported:\n");
+	printk(EDID_SPEW, "Standard timings supported:\n");
 	for (i = 0; i < 8; i++) {
 		uint8_t b1 = edid[0x26 + i * 2], b2 = edid[0x26 + i * 2 + 1];
 		unsigned int x, y = 0, refresh;
@@ -1415,7 +1418,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 			continue;
 
 		if (b1 == 0) {
-			printk(BIOS_SPEW,
+			printk(EDID_SPEW,
 				"non-conformant standard timing (0 horiz)\n");
 			continue;
 		}
@@ -1439,7 +1442,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 		}
 		refresh = 60 + (b2 & 0x3f);
 
-		printk(BIOS_SPEW, "  %dx%d@%dHz\n", x, y, refresh);
+		printk(EDID_SPEW, "  %dx%d@%dHz\n", x, y, refresh);
 		for (j = 0; j < NUM_KNOWN_MODES; j++) {
 			if (known_modes[j].ha == x && known_modes[j].va == y &&
 					known_modes[j].refresh == refresh)
@@ -1448,7 +1451,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 	}
 
 	/* detailed timings */
-	printk(BIOS_SPEW, "Detailed timings\n");
+	printk(EDID_SPEW, "Detailed timings\n");
 	for (i = 0; i < 4; i++) {
 		c.has_valid_detailed_blocks &= detailed_block(
 				out, edid + 0x36 + i * 18, 0, &c);
@@ -1461,7 +1464,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 
 	/* check this, 1.4 verification guide says otherwise */
 	if (edid[0x7e]) {
-		printk(BIOS_SPEW, "Has %d extension blocks\n", edid[0x7e]);
+		printk(EDID_SPEW, "Has %d extension blocks\n", edid[0x7e]);
 		/* 2 is impossible because of the block map */
 		if (edid[0x7e] != 2)
 			c.has_valid_extension_count = 1;
@@ -1469,7 +1472,7 @@ int decode_edid(unsigned char *edid, int size, struct edid *out)
 		c.has_valid_extension_count = 1;
 	}
 
-	printk(BIOS_SPEW, "Checksum\n");
+	printk(EDID_SPEW, "Checksum\n");
 	c.has_valid_checksum = do_checksum(edid);
 
 	/* EDID v2.0 has a larger blob (256 bytes) and may have some problem in
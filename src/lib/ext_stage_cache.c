@@ -16,11 +16,12 @@
 #include <arch/early_variables.h>
 #include <bootstate.h>
 #include <cbmem.h>
+#include <commonlib/cbfs_serialized.h>
+#include <commonlib/compression.h>
 #include <console/console.h>
 #include <imd.h>
 #include <rules.h>
 #include <stage_cache.h>
-#include <string.h>
 
 static struct imd imd_stage_cache CAR_GLOBAL = { };
 
@@ -58,11 +59,34 @@ static void stage_cache_recover(void)
 		printk(BIOS_DEBUG, "Unable to recover external stage cache.\n");
 }
 
+/* The compression scratch memory is a temporary entry. It's removed again
+ * right away, which only works as long as it's the last entry. */
+static void *scratch_add(struct imd *imd, const struct imd_entry **e)
+{
+	if (!IS_ENABLED(CONFIG_STAGE_CACHE_LZ4))
+		return NULL;
+
+	*e = imd_entry_add(imd, CBMEM_ID_STAGEx_SCRATCH,
+			   LZ4F_COMPRESS_SCRATCH_SIZE);
+	if (*e == NULL)
+		return NULL;
+
+	return imd_entry_at(imd, *e);
+}
+
+static void scratch_remove(struct imd *imd, const struct imd_entry *e)
+{
+	if (e != NULL && imd_entry_remove(imd, e))
+		printk(BIOS_DEBUG, "Could not remove stage cache scratch.\n");
+}
+
 void stage_cache_add(int stage_id, const struct prog *stage)
 {
 	struct imd *imd;
 	const struct imd_entry *e;
+	const struct imd_entry *scratch_entry = NULL;
 	struct stage_cache *meta;
+	void *scratch;
 	void *c;
 
 	imd = imd_get();
@@ -73,18 +97,23 @@ void stage_cache_add(int stage_id, const struct prog *stage)
 
 	meta = imd_entry_at(imd, e);
 
-	meta->load_addr = (uintptr_t)prog_start(stage);
-	meta->entry_addr = (uintptr_t)prog_entry(stage);
+	scratch = scratch_add(imd, &scratch_entry);
+	stage_cache_pack(meta, stage, NULL, scratch);
+	scratch_remove(imd, scratch_entry);
 
-	e = imd_entry_add(imd, CBMEM_ID_STAGEx_CACHE + stage_id,
-				prog_size(stage));
+	e = imd_entry_add(imd, CBMEM_ID_STAGEx_CACHE + stage_id, meta->size);
 
 	if (e == NULL)
 		return;
 
 	c = imd_entry_at(imd, e);
 
-	memcpy(c, prog_start(stage), prog_size(stage));
+	scratch_entry = NULL;
+	scratch = NULL;
+	if (meta->compression != CBFS_COMPRESS_NONE)
+		scratch = scratch_add(imd, &scratch_entry);
+	stage_cache_pack(meta, stage, c, scratch);
+	scratch_remove(imd, scratch_entry);
 }
 
 void stage_cache_load_stage(int stage_id, struct prog *stage)
@@ -92,8 +121,6 @@ void stage_cache_load_stage(int stage_id, struct prog *stage)
 	struct imd *imd;
 	struct stage_cache *meta;
 	const struct imd_entry *e;
-	void *c;
-	size_t size;
 
 	imd = imd_get();
 	e = imd_entry_find(imd, CBMEM_ID_STAGEx_META + stage_id);
@@ -107,13 +134,9 @@ void stage_cache_load_stage(int stage_id, struct prog *stage)
 	if (e == NULL)
 		return;
 
-	c = imd_entry_at(imd, e);
-	size = imd_entry_size(imd, e);
-
-	memcpy((void *)(uintptr_t)meta->load_addr, c, size);
-
-	prog_set_area(stage, (void *)(uintptr_t)meta->load_addr, size);
-	prog_set_entry(stage, (void *)(uintptr_t)meta->entry_addr, NULL);
+	if (stage_cache_unpack(meta, imd_entry_at(imd, e),
+			       imd_entry_size(imd, e), stage))
+		prog_set_entry(stage, NULL, NULL);
 }
 
 static void stage_cache_setup(int is_recovery)
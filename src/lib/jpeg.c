@@ -91,6 +91,7 @@ static void setinput __P((struct in *, unsigned char *));
 
 static void idctqtab __P((unsigned char *, PREC *));
 static void idct __P((int *, int *, PREC *, PREC, int));
+static void idctdc __P((int *, int *, PREC *, PREC));
 static void scaleidctqtab __P((PREC *, PREC));
 
 /*********************************/
@@ -100,6 +101,7 @@ static void initcol __P((PREC[][64]));
 static void col221111 __P((int *, unsigned char *, int));
 static void col221111_16 __P((int *, unsigned char *, int));
 static void col221111_32 __P((int *, unsigned char *, int));
+static void col221111_scaled __P((int *, unsigned char *, int, int, int));
 
 /*********************************/
 
@@ -281,13 +283,31 @@ int jpeg_check_size(unsigned char *buf, int width, int height)
 
 int jpeg_decode(unsigned char *buf, unsigned char *pic,
 		int width, int height, int depth, struct jpeg_decdata *decdata)
+{
+	return jpeg_decode_scaled(buf, pic, width, height, depth,
+		width * (depth / 8), 1, decdata);
+}
+
+int jpeg_decode_scaled(unsigned char *buf, unsigned char *pic,
+		int width, int height, int depth, int bpl, int scale,
+		struct jpeg_decdata *decdata)
 {
 	int i, j, m, tac, tdc;
 	int mcusx, mcusy, mx, my;
 	int max[6];
+	int shift, mcusize;
+	unsigned char *mcupic;
 
 	if (!decdata || !buf || !pic)
 		return -1;
+	for (shift = 0; shift < 4; shift++)
+		if (scale == 1 << shift)
+			break;
+	if (shift == 4)
+		return ERR_BAD_SCALE;
+	if (depth != 16 && depth != 24 && depth != 32)
+		return ERR_DEPTH_MISMATCH;
+	mcusize = 16 >> shift;
 	datap = buf;
 	if (getbyte() != 0xff)
 		return ERR_NO_SOI;
@@ -387,37 +407,47 @@ int jpeg_decode(unsigned char *buf, unsigned char *pic,
 					return ERR_WRONG_MARKER;
 
 			decode_mcus(&glob_in, decdata->dcts, 6, dscans, max);
-			idct(decdata->dcts, decdata->out, decdata->dquant[0],
-				IFIX(128.5), max[0]);
-			idct(decdata->dcts + 64, decdata->out + 64,
-				decdata->dquant[0], IFIX(128.5), max[1]);
-			idct(decdata->dcts + 128, decdata->out + 128,
-				decdata->dquant[0], IFIX(128.5), max[2]);
-			idct(decdata->dcts + 192, decdata->out + 192,
-				decdata->dquant[0], IFIX(128.5), max[3]);
-			idct(decdata->dcts + 256, decdata->out + 256,
-				decdata->dquant[1], IFIX(0.5), max[4]);
-			idct(decdata->dcts + 320, decdata->out + 320,
-				decdata->dquant[2], IFIX(0.5), max[5]);
+			mcupic = pic + my * mcusize * bpl
+				+ mx * mcusize * (depth / 8);
+
+			if (shift == 3) {
+				/* 1/8 scale only needs the DC coefficients */
+				for (i = 0; i < 4; i++)
+					idctdc(decdata->dcts + i * 64,
+						decdata->out + i * 64,
+						decdata->dquant[0], IFIX(128.5));
+				idctdc(decdata->dcts + 256, decdata->out + 256,
+					decdata->dquant[1], IFIX(0.5));
+				idctdc(decdata->dcts + 320, decdata->out + 320,
+					decdata->dquant[2], IFIX(0.5));
+			} else {
+				for (i = 0; i < 4; i++)
+					idct(decdata->dcts + i * 64,
+						decdata->out + i * 64,
+						decdata->dquant[0], IFIX(128.5),
+						max[i]);
+				idct(decdata->dcts + 256, decdata->out + 256,
+					decdata->dquant[1], IFIX(0.5), max[4]);
+				idct(decdata->dcts + 320, decdata->out + 320,
+					decdata->dquant[2], IFIX(0.5), max[5]);
+			}
+
+			if (shift) {
+				col221111_scaled(decdata->out, mcupic, bpl,
+					depth, shift);
+				continue;
+			}
 
 			switch (depth) {
 			case 32:
-				col221111_32(decdata->out, pic
-					+ (my * 16 * mcusx + mx) * 16 * 4,
-					mcusx * 16 * 4);
+				col221111_32(decdata->out, mcupic, bpl);
 				break;
 			case 24:
-				col221111(decdata->out, pic
-					+ (my * 16 * mcusx + mx) * 16 * 3,
-					mcusx * 16 * 3);
+				col221111(decdata->out, mcupic, bpl);
 				break;
 			case 16:
-				col221111_16(decdata->out, pic
-					+ (my * 16 * mcusx + mx) * (16 * 2),
-					mcusx * (16 * 2));
+				col221111_16(decdata->out, mcupic, bpl);
 				break;
-			default:
-				return ERR_DEPTH_MISMATCH;
 			}
 		}
 	}
@@ -733,6 +763,14 @@ void idct(int *in, int *out, PREC *lquant, PREC off, int max)
 		t3 = in[j] * lquant[j];
 		j = *zig2p++;
 		t6 = in[j] * lquant[j];
+		if ((t1 | t2 | t3 | t4 | t5 | t6 | t7) == 0) {
+			/* Only DC in this column, the IDCT is constant */
+			for (j = 0; j < 8; j++)
+				tmpp[j * 8] = t0;
+			tmpp++;
+			t0 = 0;
+			continue;
+		}
 		IDCT;
 		tmpp[0 * 8] = t0;
 		tmpp[1 * 8] = t1;
@@ -766,6 +804,12 @@ void idct(int *in, int *out, PREC *lquant, PREC off, int max)
 	}
 }
 
+/* Only computes out[0], which is all that's needed at 1/8 scale. */
+static void idctdc(int *in, int *out, PREC *lquant, PREC off)
+{
+	out[0] = ITOINT(off + in[0] * lquant[0]);
+}
+
 static unsigned char zig[64] = {
 	0, 1, 5, 6, 14, 15, 27, 28,
 	2, 4, 7, 13, 16, 26, 29, 42,
@@ -1017,3 +1061,65 @@ static void col221111_32(int *out, unsigned char *pic, int width)
 		outy += 64 * 2 - 16 * 4;
 	}
 }
+
+/*
+ * Color conversion of a 2:1:1 MCU scaled down by 1 << shift. Each output
+ * pixel averages the luma of the pixels it covers and uses the chroma sample
+ * closest to its center.
+ */
+static void col221111_scaled(int *out, unsigned char *pic, int width,
+	int depth, int shift)
+{
+	const int n = 16 >> shift;
+	const int box = 1 << shift;
+	int ox, oy, lx, ly, i, j, c;
+	int *outy, *outc;
+	int cr, cg, cb, r, g, b, y, sum;
+	unsigned char *p;
+
+	outc = out + 64 * 4;
+	for (oy = 0; oy < n; oy++, pic += width) {
+		p = pic;
+		for (ox = 0; ox < n; ox++) {
+			lx = ox << shift;
+			ly = oy << shift;
+			outy = out + ((ly >> 3) * 2 + (lx >> 3)) * 64;
+			if (shift == 3) {
+				/* idctdc() only computed the DC values */
+				y = outy[0];
+				c = 0;
+			} else {
+				sum = 0;
+				for (i = 0; i < box; i++)
+					for (j = 0; j < box; j++)
+						sum += outy[((ly & 7) + i) * 8
+							+ (lx & 7) + j];
+				y = sum >> (2 * shift);
+				c = ((ly + box / 2) >> 1) * 8
+					+ ((lx + box / 2) >> 1);
+			}
+			cb = outc[c];
+			cr = outc[64 + c];
+			cg = (50 * cb + 130 * cr + 128) >> 8;
+			r = CLAMP(y + cr);
+			g = CLAMP(y - cg);
+			b = CLAMP(y + cb);
+			switch (depth) {
+			case 32:
+				p[3] = 0;
+				/* fall through */
+			case 24:
+				p[0] = r;
+				p[1] = g;
+				p[2] = b;
+				break;
+			case 16:
+				y = (r & 0xf8) << 8 | (g & 0xfc) << 3 | b >> 3;
+				p[0] = y & 0xff;
+				p[1] = y >> 8;
+				break;
+			}
+			p += depth / 8;
+		}
+	}
+}
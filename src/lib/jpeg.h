@@ -37,6 +37,7 @@
 #define ERR_NO_EOI 13
 #define ERR_BAD_TABLES 14
 #define ERR_DEPTH_MISMATCH 15
+#define ERR_BAD_SCALE 16
 
 struct jpeg_decdata {
 	int dcts[6 * 64 + 16];
@@ -46,6 +47,14 @@ struct jpeg_decdata {
 
 int jpeg_decode(unsigned char *, unsigned char *, int, int, int,
 	struct jpeg_decdata *);
+/*
+ * Decode into a buffer with bytes_per_line stride (e.g. the framebuffer),
+ * downscaled by 1, 2, 4 or 8. width and height are the dimensions of the
+ * image as passed to jpeg_decode(); the output is width / scale pixels wide
+ * and height / scale pixels high.
+ */
+int jpeg_decode_scaled(unsigned char *, unsigned char *, int, int, int, int,
+	int, struct jpeg_decdata *);
 void jpeg_fetch_size(unsigned char *buf, int *width, int *height);
 int jpeg_check_size(unsigned char *, int, int);
 
@@ -30,10 +30,155 @@ static inline void range_entry_unlink(struct range_entry **prev_ptr,
 	r->next = NULL;
 }
 
+/* The entries are kept in an AVL tree ordered by their begin address in
+ * addition to the sorted list. As entries never overlap, shrinking or
+ * growing an entry in place never changes its position in either. */
+static inline int range_tree_height(const struct range_entry *r)
+{
+	return r != NULL ? r->height : 0;
+}
+
+static void range_tree_update_height(struct range_entry *r)
+{
+	r->height = MAX(range_tree_height(r->left),
+			range_tree_height(r->right)) + 1;
+}
+
+static struct range_entry *range_tree_rotate_right(struct range_entry *r)
+{
+	struct range_entry *l = r->left;
+
+	r->left = l->right;
+	l->right = r;
+	range_tree_update_height(r);
+	range_tree_update_height(l);
+	return l;
+}
+
+static struct range_entry *range_tree_rotate_left(struct range_entry *r)
+{
+	struct range_entry *rr = r->right;
+
+	r->right = rr->left;
+	rr->left = r;
+	range_tree_update_height(r);
+	range_tree_update_height(rr);
+	return rr;
+}
+
+static struct range_entry *range_tree_balance(struct range_entry *r)
+{
+	const int balance = range_tree_height(r->right) -
+			    range_tree_height(r->left);
+
+	range_tree_update_height(r);
+
+	if (balance > 1) {
+		if (range_tree_height(r->right->left) >
+		    range_tree_height(r->right->right))
+			r->right = range_tree_rotate_right(r->right);
+		return range_tree_rotate_left(r);
+	}
+	if (balance < -1) {
+		if (range_tree_height(r->left->right) >
+		    range_tree_height(r->left->left))
+			r->left = range_tree_rotate_left(r->left);
+		return range_tree_rotate_right(r);
+	}
+	return r;
+}
+
+static struct range_entry *range_tree_insert(struct range_entry *root,
+					     struct range_entry *r)
+{
+	if (root == NULL) {
+		r->left = NULL;
+		r->right = NULL;
+		r->height = 1;
+		return r;
+	}
+
+	if (r->begin < root->begin)
+		root->left = range_tree_insert(root->left, r);
+	else
+		root->right = range_tree_insert(root->right, r);
+
+	return range_tree_balance(root);
+}
+
+static struct range_entry *range_tree_remove_min(struct range_entry *root,
+						 struct range_entry **min)
+{
+	if (root->left == NULL) {
+		*min = root;
+		return root->right;
+	}
+	root->left = range_tree_remove_min(root->left, min);
+	return range_tree_balance(root);
+}
+
+static struct range_entry *range_tree_remove(struct range_entry *root,
+					     struct range_entry *r)
+{
+	struct range_entry *min;
+
+	if (root == NULL)
+		return NULL;
+
+	if (r->begin < root->begin) {
+		root->left = range_tree_remove(root->left, r);
+	} else if (r->begin > root->begin) {
+		root->right = range_tree_remove(root->right, r);
+	} else {
+		/* Replace the entry by its successor. */
+		if (root->right == NULL)
+			return root->left;
+		root->right = range_tree_remove_min(root->right, &min);
+		min->left = root->left;
+		min->right = root->right;
+		root = min;
+	}
+
+	return range_tree_balance(root);
+}
+
+/* Return the link pointing to the first entry that ends at or after addr.
+ * That is where an entry beginning at addr would have to be inserted. */
+static struct range_entry **range_lookup_link(struct memranges *ranges,
+					      resource_t addr)
+{
+	struct range_entry **prev_ptr;
+	struct range_entry *prev;
+	struct range_entry *cur;
+
+	if (!IS_ENABLED(CONFIG_MEMRANGE_TREE)) {
+		prev_ptr = &ranges->entries;
+		while (*prev_ptr != NULL && (*prev_ptr)->end < addr)
+			prev_ptr = &(*prev_ptr)->next;
+		return prev_ptr;
+	}
+
+	/* Find the last entry that ends before addr. */
+	prev = NULL;
+	cur = ranges->root;
+	while (cur != NULL) {
+		if (cur->end < addr) {
+			prev = cur;
+			cur = cur->right;
+		} else {
+			cur = cur->left;
+		}
+	}
+
+	return prev != NULL ? &prev->next : &ranges->entries;
+}
+
 static inline void range_entry_unlink_and_free(struct memranges *ranges,
 					       struct range_entry **prev_ptr,
 					       struct range_entry *r)
 {
+	if (IS_ENABLED(CONFIG_MEMRANGE_TREE))
+		ranges->root = range_tree_remove(ranges->root, r);
 	range_entry_unlink(prev_ptr, r);
 	range_entry_link(&ranges->free_list, r);
 }
@@ -67,6 +212,8 @@ range_list_add(struct memranges *ranges, struct range_entry **prev_ptr,
 	new_entry->end = end;
 	new_entry->tag = tag;
 	range_entry_link(prev_ptr, new_entry);
+	if (IS_ENABLED(CONFIG_MEMRANGE_TREE))
+		ranges->root = range_tree_insert(ranges->root, new_entry);
 
 	return new_entry;
 }
@@ -109,8 +256,8 @@ static void remove_memranges(struct memranges *ranges,
 	struct range_entry *next;
 	struct range_entry **prev_ptr;
 
-	prev_ptr = &ranges->entries;
-	for (cur = ranges->entries; cur != NULL; cur = next) {
+	prev_ptr = range_lookup_link(ranges, begin);
+	for (cur = *prev_ptr; cur != NULL; cur = next) {
 		resource_t tmp_end;
 
 		/* Cache the next value to handle unlinks. */
@@ -167,38 +314,48 @@ static void remove_memranges(struct memranges *ranges,
 	}
 }
 
-static void merge_add_memranges(struct memranges *ranges,
-				resource_t begin, resource_t end,
-				unsigned long tag)
+/* Merge an entry with its direct neighbors if they carry the same tag. */
+static void merge_entry_with_neighbors(struct memranges *ranges,
+				       struct range_entry *r)
 {
-	struct range_entry *cur;
 	struct range_entry **prev_ptr;
+	struct range_entry *next;
 
-	prev_ptr = &ranges->entries;
+	next = r->next;
+	if (next != NULL && r->end + 1 >= next->begin && r->tag == next->tag) {
+		r->end = next->end;
+		range_entry_unlink_and_free(ranges, &r->next, next);
+	}
 
-	/* Remove all existing entries covered by the range. */
-	remove_memranges(ranges, begin, end, -1);
+	if (r->begin == 0)
+		return;
 
-	/* Find the entry to place the new entry after. Since
-	 * remove_memranges() was called above there is a guaranteed
-	 * spot for this new entry. */
-	for (cur = ranges->entries; cur != NULL; cur = cur->next) {
-		/* Found insertion spot before current entry. */
-		if (end < cur->begin)
-			break;
+	/* Points to r unless an entry ends right before it. */
+	prev_ptr = range_lookup_link(ranges, r->begin - 1);
+	if (*prev_ptr != r && (*prev_ptr)->tag == r->tag) {
+		struct range_entry *prev = *prev_ptr;
 
-		/* Keep track of previous entry to insert new entry after it. */
-		prev_ptr = &cur->next;
+		prev->end = r->end;
+		range_entry_unlink_and_free(ranges, &prev->next, r);
+	}
+}
 
-		/* The new entry starts after this one. */
-		if (begin > cur->end)
-			continue;
+static void merge_add_memranges(struct memranges *ranges,
+				resource_t begin, resource_t end,
+				unsigned long tag)
+{
+	struct range_entry *new_entry;
 
-	}
+	/* Remove all existing entries covered by the range. */
+	remove_memranges(ranges, begin, end, -1);
 
-	/* Add new entry and merge with neighbors. */
-	range_list_add(ranges, prev_ptr, begin, end, tag);
-	merge_neighbor_entries(ranges);
+	/* Since remove_memranges() was called above there is a guaranteed
+	 * spot for this new entry in front of the first entry ending after
+	 * begin. */
+	new_entry = range_list_add(ranges, range_lookup_link(ranges, begin),
+				   begin, end, tag);
+	if (new_entry != NULL)
+		merge_entry_with_neighbors(ranges, new_entry);
 }
 
 void memranges_update_tag(struct memranges *ranges, unsigned long old_tag,
@@ -296,6 +453,7 @@ void memranges_init_empty(struct memranges *ranges, struct range_entry *to_free,
 	size_t i;
 
 	ranges->entries = NULL;
+	ranges->root = NULL;
 	ranges->free_list = NULL;
 
 	for (i = 0; i < num_free; i++)
@@ -332,6 +490,10 @@ void memranges_fill_holes_up_to(struct memranges *ranges,
 			continue;
 		}
 
+		/* The previous entry already reaches up to the limit. */
+		if (range_entry_end(prev) >= limit)
+			break;
+
 		/* If the previous entry does not directly precede the current
 		 * entry then add a new entry just after the previous one. */
 		if (range_entry_end(prev) != cur->begin) {
@@ -362,6 +524,17 @@ void memranges_fill_holes_up_to(struct memranges *ranges,
 	merge_neighbor_entries(ranges);
 }
 
+struct range_entry *memranges_find_entry(struct memranges *ranges,
+					 resource_t addr)
+{
+	struct range_entry *r;
+
+	r = *range_lookup_link(ranges, addr);
+	if (r == NULL || r->begin > addr)
+		return NULL;
+	return r;
+}
+
 struct range_entry *memranges_next_entry(struct memranges *ranges,
 					 const struct range_entry *r)
 {
@@ -40,6 +40,11 @@
  * write and the data write results in blocks being allocated but not
  * entirely written. It's up to the user of the library to sanity check
  * data stored.
+ *
+ * The storage is assumed to behave like NOR flash: erased bytes read as
+ * 0xff and data blocks past the latest update are still erased. Updates
+ * that match the latest data aren't written at all, and chunks of an
+ * update that only contain erased bytes aren't programmed.
  */
 
 #define REGF_BLOCK_SHIFT		4
@@ -48,6 +53,9 @@
 #define REGF_UNALLOCATED_BLOCK		0xffff
 #define REGF_UPDATES_PER_METADATA_BLOCK	\
 	(REGF_METADATA_BLOCK_SIZE / sizeof(uint16_t))
+/* Data is compared and programmed in naturally aligned chunks of this size. */
+#define REGF_IO_CHUNK_SIZE		256
+#define REGF_ERASED_BYTE		0xff
 
 enum {
 	RF_ONLY_METADATA = 0,
@@ -378,12 +386,88 @@ static int commit_data_allocation(struct region_file *f, size_t data_blks)
 	return 0;
 }
 
+/* Size of the chunk at offset that ends at the next chunk boundary. */
+static size_t io_chunk_size(size_t offset, size_t left)
+{
+	return MIN(REGF_IO_CHUNK_SIZE - offset % REGF_IO_CHUNK_SIZE, left);
+}
+
+static int is_erased(const uint8_t *buf, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		if (buf[i] != REGF_ERASED_BYTE)
+			return 0;
+	}
+
+	return 1;
+}
+
+/* Returns 1 if the latest update holds buf followed by erased bytes up to
+ * the end of its last block, i.e. writing buf again changes nothing. */
+static int update_is_identical(const struct region_file *f, size_t blocks,
+				const void *buf, size_t size)
+{
+	uint8_t chunk[REGF_IO_CHUNK_SIZE];
+	const uint8_t *data = buf;
+	size_t offset, total, i, len;
+
+	if (f->slot <= RF_ONLY_METADATA)
+		return 0;
+
+	if (region_file_data_end(f) - region_file_data_begin(f) != blocks)
+		return 0;
+
+	offset = block_to_bytes(region_file_data_begin(f));
+	total = block_to_bytes(blocks);
+
+	for (i = 0; i < total; i += len) {
+		size_t n;
+
+		len = io_chunk_size(offset + i, total - i);
+		if (rdev_readat(&f->rdev, chunk, offset + i, len) < 0)
+			return 0;
+
+		n = i < size ? MIN(len, size - i) : 0;
+		if (memcmp(chunk, &data[i], n) || !is_erased(&chunk[n], len - n))
+			return 0;
+	}
+
+	return 1;
+}
+
 static int commit_data(const struct region_file *f, const void *buf,
 			size_t size)
 {
+	const uint8_t *data = buf;
 	size_t offset = block_to_bytes(region_file_data_begin(f));
-	if (rdev_writeat(&f->rdev, buf, offset, size) < 0)
-		return -1;
+	size_t start = 0;
+
+	/* The data blocks are erased. Skip chunks that would leave them that
+	 * way and program runs of the remaining chunks in one write each. */
+	while (start < size) {
+		size_t end, len;
+
+		len = io_chunk_size(offset + start, size - start);
+		if (is_erased(&data[start], len)) {
+			start += len;
+			continue;
+		}
+
+		for (end = start + len; end < size; end += len) {
+			len = io_chunk_size(offset + end, size - end);
+			if (is_erased(&data[end], len))
+				break;
+		}
+
+		if (rdev_writeat(&f->rdev, &data[start], offset + start,
+				 end - start) < 0)
+			return -1;
+
+		start = end;
+	}
+
 	return 0;
 }
 
@@ -441,6 +525,11 @@ int region_file_update_data(struct region_file *f, const void *buf, size_t size)
 
 	blocks = bytes_to_block(ALIGN_UP(size, REGF_BLOCK_GRANULARITY));
 
+	if (update_is_identical(f, blocks, buf, size)) {
+		printk(BIOS_DEBUG, "REGF update matches latest data.\n");
+		return 0;
+	}
+
 	while (1) {
 		int prev_slot = f->slot;
 
@@ -54,7 +54,8 @@ int rmodule_parse(void *ptr, struct rmodule *module)
 	/* Sanity check the raw data. */
 	if (rhdr->magic != RMODULE_MAGIC)
 		return -1;
-	if (rhdr->version != RMODULE_VERSION_1)
+	if (rhdr->version != RMODULE_VERSION_1 &&
+	    rhdr->version != RMODULE_VERSION_2)
 		return -1;
 
 	/* Indicate the module hasn't been loaded yet. */
@@ -171,6 +172,66 @@ static int rmodule_relocate(const struct rmodule *module)
 	return 0;
 }
 
+/*
+ * Apply the relocations of a RMODULE_VERSION_2 module. The runs are decoded
+ * while they are applied and checked against the payload bounds since they
+ * aren't fixed size entries like the ones of RMODULE_VERSION_1.
+ */
+static int rmodule_relocate_runs(const struct rmodule *module)
+{
+	const uint8_t *reloc = module->relocations;
+	const uint8_t *reloc_end;
+	char *payload = module->location;
+	const uintptr_t link = module->header->module_link_start_address;
+	const size_t size = module->payload_size;
+	uintptr_t adjustment;
+	size_t addr, pos, num_runs, num_relocations;
+
+	reloc_end = reloc + module->header->relocations_end_offset -
+			module->header->relocations_begin_offset;
+	adjustment = (uintptr_t)rmodule_load_addr(module, 0);
+
+	addr = 0;
+	pos = 0;
+	num_runs = 0;
+	num_relocations = 0;
+
+	while (reloc < reloc_end) {
+		size_t distance, count, offset;
+		uintptr_t *adjust_loc;
+
+		if (rmodule_get_reloc_run(&reloc, reloc_end, &distance,
+					  &count))
+			goto malformed;
+
+		addr += distance;
+		offset = addr - link;
+		if (addr < link || offset < pos || offset > size ||
+		    count > size / sizeof(uintptr_t) ||
+		    count * sizeof(uintptr_t) > size - offset)
+			goto malformed;
+
+		adjust_loc = (uintptr_t *)&payload[offset];
+		addr += count * sizeof(uintptr_t);
+		pos = offset + count * sizeof(uintptr_t);
+		num_relocations += count;
+		num_runs++;
+
+		while (count--)
+			*adjust_loc++ += adjustment;
+	}
+
+	printk(BIOS_DEBUG, "Processed %zu relocs in %zu runs. Offset value of "
+	       "0x%08lx\n", num_relocations, num_runs,
+	       (unsigned long)adjustment);
+
+	return 0;
+
+malformed:
+	printk(BIOS_ERR, "Malformed rmodule relocations.\n");
+	return -1;
+}
+
 int rmodule_load_alignment(const struct rmodule *module)
 {
 	/* The load alignment is the start of the program's linked address.
@@ -193,8 +254,12 @@ int rmodule_load(void *base, struct rmodule *module)
 	 */
 	module->location = base;
 	rmodule_copy_payload(module);
-	if (rmodule_relocate(module))
+	if (module->header->version == RMODULE_VERSION_2) {
+		if (rmodule_relocate_runs(module))
+			return -1;
+	} else if (rmodule_relocate(module)) {
 		return -1;
+	}
 	rmodule_clear_bss(module);
 
 	prog_segment_loaded((uintptr_t)module->location,
@@ -0,0 +1,119 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <commonlib/cbfs_serialized.h>
+#include <commonlib/compression.h>
+#include <commonlib/endian.h>
+#include <console/console.h>
+#include <stage_cache.h>
+#include <string.h>
+#include <timestamp.h>
+
+/* FNV-1a over 32-bit words. It only has to catch the cache getting
+ * overwritten between boot and resume, but it runs on every resume. */
+static uint32_t stage_cache_checksum(const void *data, size_t size)
+{
+	const uint8_t *p = data;
+	uint32_t hash = 2166136261U;
+
+	for (; size >= sizeof(uint32_t); size -= sizeof(uint32_t)) {
+		hash = (hash ^ read_le32(p)) * 16777619U;
+		p += sizeof(uint32_t);
+	}
+	for (; size != 0; size--)
+		hash = (hash ^ *p++) * 16777619U;
+
+	return hash;
+}
+
+size_t stage_cache_pack(struct stage_cache *meta, const struct prog *stage,
+			void *dst, void *scratch)
+{
+	const void *src = prog_start(stage);
+
+	if (dst == NULL) {
+		size_t size;
+
+		meta->load_addr = (uintptr_t)src;
+		meta->entry_addr = (uintptr_t)prog_entry(stage);
+		meta->compression = CBFS_COMPRESS_NONE;
+		meta->load_size = prog_size(stage);
+		meta->size = meta->load_size;
+
+		if (scratch == NULL)
+			return meta->size;
+
+		size = lz4f_compress(src, meta->load_size, NULL, 0, scratch);
+		if (size < meta->size) {
+			meta->compression = CBFS_COMPRESS_LZ4;
+			meta->size = size;
+		}
+		return meta->size;
+	}
+
+	if (meta->compression == CBFS_COMPRESS_LZ4) {
+		if (scratch == NULL ||
+		    lz4f_compress(src, meta->load_size, dst, meta->size,
+				  scratch) != meta->size) {
+			printk(BIOS_ERR, "ERROR: Stage cache compression "
+			       "failed.\n");
+			/* Let stage_cache_unpack() reject the image. */
+			meta->load_size = 0;
+		}
+	} else {
+		memcpy(dst, src, meta->size);
+	}
+
+	meta->checksum = stage_cache_checksum(dst, meta->size);
+
+	printk(BIOS_DEBUG, "Stage cache: %u bytes at 0x%llx stored in %u "
+	       "bytes.\n", meta->load_size, meta->load_addr, meta->size);
+
+	return meta->size;
+}
+
+int stage_cache_unpack(const struct stage_cache *meta, const void *c,
+		       size_t size, struct prog *stage)
+{
+	void *load_addr = (void *)(uintptr_t)meta->load_addr;
+	size_t load_size;
+
+	timestamp_add_now(TS_START_STAGE_CACHE_LOAD);
+
+	if (size < meta->size || meta->load_size == 0 ||
+	    stage_cache_checksum(c, meta->size) != meta->checksum) {
+		printk(BIOS_ERR, "ERROR: Stage cache is corrupted.\n");
+		return -1;
+	}
+
+	timestamp_add_now(TS_STAGE_CACHE_VERIFIED);
+
+	if (meta->compression == CBFS_COMPRESS_LZ4) {
+		load_size = ulz4fn(c, meta->size, load_addr, meta->load_size);
+	} else {
+		load_size = MIN(meta->size, meta->load_size);
+		memcpy(load_addr, c, load_size);
+	}
+
+	if (load_size != meta->load_size) {
+		printk(BIOS_ERR, "ERROR: Stage cache image is invalid.\n");
+		return -1;
+	}
+
+	timestamp_add_now(TS_END_STAGE_CACHE_LOAD);
+
+	prog_set_area(stage, load_addr, load_size);
+	prog_set_entry(stage, (void *)(uintptr_t)meta->entry_addr, NULL);
+
+	return 0;
+}
@@ -32,14 +32,27 @@
 #include <soc/smm.h>
 #include <cpu/intel/turbo.h>
 
-static const struct reg_script core_msr_script[] = {
+/*
+ * Core MSRs that get the same value on every core. The BSP writes them before
+ * starting the APs, which get them from the SIPI vector. The C-state
+ * configuration is locked later by core_msr_script, as it always was.
+ */
+static const struct {
+	uint32_t index;
+	uint32_t lo;
+} core_msrs[] = {
 	/* Enable C-state and IO/MWAIT redirect */
-	REG_MSR_WRITE(MSR_PMG_CST_CONFIG_CONTROL,
+	{ MSR_PMG_CST_CONFIG_CONTROL,
 		(PKG_C_STATE_LIMIT_C2_MASK | CORE_C_STATE_LIMIT_C10_MASK
-		| IO_MWAIT_REDIRECT_MASK | CST_CFG_LOCK_MASK)),
+		| IO_MWAIT_REDIRECT_MASK) },
 	/* Power Management I/O base address for I/O trapping to C-states */
-	REG_MSR_WRITE(MSR_PMG_IO_CAPTURE_BASE,
-		(ACPI_PMIO_CST_REG | (PMG_IO_BASE_CST_RNG_BLK_SIZE << 16))),
+	{ MSR_PMG_IO_CAPTURE_BASE,
+		(ACPI_PMIO_CST_REG | (PMG_IO_BASE_CST_RNG_BLK_SIZE << 16)) },
+};
+
+static const struct reg_script core_msr_script[] = {
+	/* Lock the C-state configuration */
+	REG_MSR_OR(MSR_PMG_CST_CONFIG_CONTROL, CST_CFG_LOCK_MASK),
 	/* Disable C1E */
 	REG_MSR_RMW(MSR_POWER_CTL, ~0x2, 0),
 	/* Disable support for MONITOR and MWAIT instructions */
@@ -141,6 +154,19 @@ static void get_microcode_info(const void **microcode, int *parallel)
 	*parallel = 1;
 }
 
+static void add_ap_msrs(void)
+{
+	msr_t msr;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(core_msrs); i++) {
+		msr.lo = core_msrs[i].lo;
+		msr.hi = 0;
+		wrmsr(core_msrs[i].index, msr);
+		mp_add_ap_msr(core_msrs[i].index, msr);
+	}
+}
+
 static void get_smm_info(uintptr_t *perm_smbase, size_t *perm_smsize,
 				size_t *smm_save_state_size)
 {
@@ -193,6 +219,7 @@ static const struct mp_ops mp_ops = {
 	.get_cpu_count = get_cpu_count,
 	.get_smm_info = get_smm_info,
 	.get_microcode_info = get_microcode_info,
+	.add_ap_msrs = add_ap_msrs,
 	.pre_mp_smm_init = southbridge_smm_clear_state,
 	.relocation_handler = relocation_handler,
 	.post_mp_init = southbridge_smm_enable_smi,
@@ -581,5 +581,15 @@ uint32_t antirollback_write_space_rec_hash(const uint8_t *data, uint32_t size)
 	if (rv != TPM_SUCCESS)
 		return rv;
 
+	/*
+	 * The hash is updated on every recovery boot, but the recovery MRC
+	 * data rarely changes. Skip the NV write and the read back if the
+	 * space already holds this hash.
+	 */
+	if (!memcmp(spc_data, data, size)) {
+		VBDEBUG("TPM: Recovery hash unchanged, skipping the write.\n");
+		return TPM_SUCCESS;
+	}
+
 	return write_secdata(REC_HASH_NV_INDEX, data, size);
 }
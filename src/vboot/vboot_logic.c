@@ -31,6 +31,14 @@
 
 #define TODO_BLOCK_SIZE 1024
 
+/*
+ * The body is hashed in chunks of this size mapped with rdev_mmap(). That is
+ * free on memory mapped boot media and otherwise reads the chunk into the
+ * CBFS cache with a single transfer. Chunks that don't fit in the cache are
+ * read TODO_BLOCK_SIZE bytes at a time.
+ */
+#define HASH_CHUNK_SIZE (32 * KiB)
+
 static int is_slot_a(struct vb2_context *ctx)
 {
 	return !(ctx->flags & VB2_CONTEXT_FW_SLOT_B);
@@ -186,8 +194,8 @@ static int hash_body(struct vb2_context *ctx, struct region_device *fw_main)
 	uint8_t block[TODO_BLOCK_SIZE];
 	uint8_t hash_digest[VBOOT_MAX_HASH_SIZE];
 	const size_t hash_digest_sz = sizeof(hash_digest);
-	size_t block_size = sizeof(block);
 	size_t offset;
+	int can_map = 1;
 	int rv;
 
 	/* Clear the full digest so that any hash digests less than the
@@ -225,20 +233,32 @@ static int hash_body(struct vb2_context *ctx, struct region_device *fw_main)
 	/* Extend over the body */
 	while (expected_size) {
 		uint64_t temp_ts;
-		if (block_size > expected_size)
-			block_size = expected_size;
+		size_t size = MIN(expected_size, HASH_CHUNK_SIZE);
+		void *data = NULL;
 
 		temp_ts = timestamp_get();
-		if (rdev_readat(fw_main, block, offset, block_size) < 0)
-			return VB2_ERROR_UNKNOWN;
-		load_ts += timestamp_get() - temp_ts;
+		if (can_map)
+			data = rdev_mmap(fw_main, offset, size);
+
+		if (data != NULL) {
+			load_ts += timestamp_get() - temp_ts;
+			rv = vb2api_extend_hash(ctx, data, size);
+			rdev_munmap(fw_main, data);
+		} else {
+			/* The cache won't get bigger, stop trying to map. */
+			can_map = 0;
+			size = MIN(expected_size, sizeof(block));
+			if (rdev_readat(fw_main, block, offset, size) < 0)
+				return VB2_ERROR_UNKNOWN;
+			load_ts += timestamp_get() - temp_ts;
+			rv = vb2api_extend_hash(ctx, block, size);
+		}
 
-		rv = vb2api_extend_hash(ctx, block, block_size);
 		if (rv)
 			return rv;
 
-		expected_size -= block_size;
-		offset += block_size;
+		expected_size -= size;
+		offset += size;
 	}
 
 	timestamp_add(TS_DONE_LOADING, load_ts);
@@ -21,6 +21,7 @@ enum {
 	GOOGLE_VPD_2_0_OFFSET = 0x600,
 	CROSVPD_CBMEM_MAGIC = 0x43524f53,
 	CROSVPD_CBMEM_VERSION = 0x0001,
+	CROSVPD_INDEX_MAGIC = 0x56504449,
 };
 
 struct vpd_gets_arg {
@@ -41,6 +42,35 @@ struct vpd_cbmem {
 	 */
 };
 
+/*
+ * Hash table over the keys of the RO VPD, kept in CBMEM_ID_VPD_INDEX next to
+ * the copy in CBMEM_ID_VPD so that cros_vpd_find() doesn't have to decode the
+ * whole VPD for every key. It's a separate entry because payloads know the
+ * layout of the VPD copy. The entries are followed by num_slots slots, each
+ * holding 0 or an entry's index + 1.
+ */
+struct vpd_index_entry {
+	uint32_t hash;
+	uint32_t key_offset;	/* Offsets into the blob of struct vpd_cbmem */
+	uint32_t key_len;
+	uint32_t value_offset;
+	uint32_t value_len;
+};
+
+struct vpd_index {
+	uint32_t magic;
+	uint32_t num_entries;
+	uint32_t num_slots;	/* Power of 2 */
+	uint32_t reserved;
+	struct vpd_index_entry entries[0];
+};
+
+struct vpd_index_arg {
+	const struct vpd_cbmem *vpd;
+	struct vpd_index *index;
+	uint32_t num_keys;
+};
+
 /* returns the size of data in a VPD 2.0 formatted fmap region, or 0 */
 static int32_t get_vpd_size(const char *fmap_name, int32_t *base)
 {
@@ -87,6 +117,136 @@ static int32_t get_vpd_size(const char *fmap_name, int32_t *base)
 	return size;
 }
 
+/* FNV-1a */
+static uint32_t vpd_key_hash(const uint8_t *key, int32_t key_len)
+{
+	uint32_t hash = 2166136261U;
+
+	while (key_len-- > 0)
+		hash = (hash ^ *key++) * 16777619U;
+
+	return hash;
+}
+
+static uint16_t *vpd_index_slots(const struct vpd_index *index)
+{
+	return (uint16_t *)&index->entries[index->num_entries];
+}
+
+/* Returns the entry for key or NULL. */
+static const struct vpd_index_entry *vpd_index_lookup(
+	const struct vpd_index *index, const uint8_t *blob,
+	const uint8_t *key, int32_t key_len)
+{
+	const uint16_t *slots = vpd_index_slots(index);
+	const uint32_t mask = index->num_slots - 1;
+	const uint32_t hash = vpd_key_hash(key, key_len);
+	uint32_t i;
+
+	for (i = hash & mask; slots[i] != 0; i = (i + 1) & mask) {
+		const struct vpd_index_entry *e = &index->entries[slots[i] - 1];
+
+		if (e->hash == hash && e->key_len == key_len &&
+		    memcmp(&blob[e->key_offset], key, key_len) == 0)
+			return e;
+	}
+
+	return NULL;
+}
+
+static void vpd_walk(const struct vpd_cbmem *vpd, VpdDecodeCallback callback,
+		     void *arg)
+{
+	int32_t consumed = 0;
+
+	while (VPD_OK == decodeVpdString(vpd->ro_size, vpd->blob, &consumed,
+					 callback, arg)) {
+		/* Iterate until the callback stops or no more entries. */
+	}
+}
+
+static int vpd_count_callback(const uint8_t *key, int32_t key_len,
+			      const uint8_t *value, int32_t value_len,
+			      void *arg)
+{
+	struct vpd_index_arg *a = arg;
+
+	a->num_keys++;
+	return VPD_OK;
+}
+
+static int vpd_index_callback(const uint8_t *key, int32_t key_len,
+			      const uint8_t *value, int32_t value_len,
+			      void *arg)
+{
+	struct vpd_index_arg *a = arg;
+	struct vpd_index *index = a->index;
+	uint16_t *slots = vpd_index_slots(index);
+	const uint32_t mask = index->num_slots - 1;
+	struct vpd_index_entry *e;
+	uint32_t i;
+
+	/* The first of duplicate keys wins, like in a linear search. */
+	if (vpd_index_lookup(index, a->vpd->blob, key, key_len))
+		return VPD_OK;
+
+	e = &index->entries[a->num_keys];
+	e->hash = vpd_key_hash(key, key_len);
+	e->key_offset = key - a->vpd->blob;
+	e->key_len = key_len;
+	e->value_offset = value - a->vpd->blob;
+	e->value_len = value_len;
+
+	for (i = e->hash & mask; slots[i] != 0; i = (i + 1) & mask)
+		;
+	slots[i] = ++a->num_keys;
+
+	return VPD_OK;
+}
+
+static void cbmem_add_cros_vpd_index(const struct vpd_cbmem *vpd)
+{
+	struct vpd_index_arg arg = { .vpd = vpd };
+	struct vpd_index *index;
+	uint32_t num_slots = 4;
+
+	vpd_walk(vpd, vpd_count_callback, &arg);
+
+	/* Slots hold 16-bit entry numbers. */
+	if (arg.num_keys == 0 || arg.num_keys >= 0xffff)
+		return;
+
+	/* Keep the table at most half full. */
+	while (num_slots < 2 * arg.num_keys)
+		num_slots *= 2;
+
+	index = cbmem_add(CBMEM_ID_VPD_INDEX, sizeof(*index) +
+			  arg.num_keys * sizeof(index->entries[0]) +
+			  num_slots * sizeof(uint16_t));
+	if (!index) {
+		printk(BIOS_ERR, "%s: Failed to allocate CBMEM.\n", __func__);
+		return;
+	}
+
+	index->magic = 0;
+	index->num_entries = arg.num_keys;
+	index->num_slots = num_slots;
+	memset(vpd_index_slots(index), 0, num_slots * sizeof(uint16_t));
+
+	arg.index = index;
+	arg.num_keys = 0;
+	vpd_walk(vpd, vpd_index_callback, &arg);
+
+	/* Move the slots down over the entries of skipped duplicates. */
+	if (arg.num_keys != index->num_entries) {
+		memmove(&index->entries[arg.num_keys], vpd_index_slots(index),
+			num_slots * sizeof(uint16_t));
+		index->num_entries = arg.num_keys;
+	}
+
+	index->magic = CROSVPD_INDEX_MAGIC;
+}
+
 static void cbmem_add_cros_vpd(int is_recovery)
 {
 	struct region_device vpd;
@@ -159,6 +319,9 @@ static void cbmem_add_cros_vpd(int is_recovery)
 		}
 		timestamp_add_now(TS_END_COPYVPD_RW);
 	}
+
+	if (cbmem->ro_size)
+		cbmem_add_cros_vpd_index(cbmem);
 }
 
 static int vpd_gets_callback(const uint8_t *key, int32_t key_len,
@@ -181,8 +344,8 @@ static int vpd_gets_callback(const uint8_t *key, int32_t key_len,
 const void *cros_vpd_find(const char *key, int *size)
 {
 	struct vpd_gets_arg arg = {0};
-	int consumed = 0;
 	const struct vpd_cbmem *vpd;
+	const struct vpd_index *index;
 
 	vpd = cbmem_find(CBMEM_ID_VPD);
 	if (!vpd || !vpd->ro_size)
@@ -191,11 +354,20 @@ const void *cros_vpd_find(const char *key, int *size)
 	arg.key = (const uint8_t *)key;
 	arg.key_len = strlen(key);
 
-	while (VPD_OK == decodeVpdString(vpd->ro_size, vpd->blob, &consumed,
-					 vpd_gets_callback, &arg)) {
-		/* Iterate until found or no more entries. */
+	index = cbmem_find(CBMEM_ID_VPD_INDEX);
+	if (index && index->magic == CROSVPD_INDEX_MAGIC) {
+		const struct vpd_index_entry *e;
+
+		e = vpd_index_lookup(index, vpd->blob, arg.key, arg.key_len);
+		if (!e)
+			return NULL;
+
+		*size = e->value_len;
+		return &vpd->blob[e->value_offset];
 	}
 
+	vpd_walk(vpd, vpd_gets_callback, &arg);
+
 	if (!arg.matched)
 		return NULL;
 
@@ -223,4 +395,36 @@ char *cros_vpd_gets(const char *key, char *buffer, int size)
 	return buffer;
 }
 
+struct vpd_foreach_arg {
+	cros_vpd_callback_t callback;
+	void *arg;
+	int ret;
+};
+
+static int vpd_foreach_callback(const uint8_t *key, int32_t key_len,
+				const uint8_t *value, int32_t value_len,
+				void *arg)
+{
+	struct vpd_foreach_arg *a = arg;
+
+	a->ret = a->callback((const char *)key, key_len, value, value_len,
+			     a->arg);
+
+	return a->ret ? VPD_FAIL : VPD_OK;
+}
+
+int cros_vpd_foreach(cros_vpd_callback_t callback, void *arg)
+{
+	struct vpd_foreach_arg a = { .callback = callback, .arg = arg };
+	const struct vpd_cbmem *vpd;
+
+	vpd = cbmem_find(CBMEM_ID_VPD);
+	if (!vpd || !vpd->ro_size)
+		return -1;
+
+	vpd_walk(vpd, vpd_foreach_callback, &a);
+
+	return a.ret;
+}
+
 RAMSTAGE_CBMEM_INIT_HOOK(cbmem_add_cros_vpd)
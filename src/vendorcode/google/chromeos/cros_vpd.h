@@ -37,4 +37,17 @@ char *cros_vpd_gets(const char *key, char *buffer, int size);
 
 const void *cros_vpd_find(const char *key, int *size);
 
+typedef int (*cros_vpd_callback_t)(const char *key, int key_len,
+				   const void *value, int value_len,
+				   void *arg);
+
+/*
+ * Call callback for every VPD entry in the order they are stored, with
+ * pointers into the VPD cache like cros_vpd_find(). The key is not null
+ * terminated. The walk stops at the first non-zero return of callback.
+ *
+ * Returns the last return value of callback, or -1 if there is no VPD.
+ */
+int cros_vpd_foreach(cros_vpd_callback_t callback, void *arg);
+
 #endif  /* __CROS_VPD_H__ */
@@ -79,9 +79,42 @@ static const char * const templates[] = {
 	"wifi_calibrationX"
 };
 
+/* VPD values of the calibration keys, indexed by template and interface. */
+struct calibration_values {
+	const void *payload[ARRAY_SIZE(templates)][MAX_WIFI_INTERFACE_COUNT];
+	int payload_size[ARRAY_SIZE(templates)][MAX_WIFI_INTERFACE_COUNT];
+};
+
+static int find_calibration_key(const char *key, int key_len,
+				const void *value, int value_len, void *arg)
+{
+	struct calibration_values *values = arg;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(templates); i++) {
+		const int index_location = strlen(templates[i]) - 1;
+		int j;
+
+		if (key_len != index_location + 1 ||
+		    memcmp(key, templates[i], index_location))
+			continue;
+
+		j = key[index_location] - '0';
+		/* Keep the first of duplicate keys, like cros_vpd_find(). */
+		if (j < 0 || j >= MAX_WIFI_INTERFACE_COUNT ||
+		    values->payload[i][j])
+			continue;
+
+		values->payload[i][j] = value;
+		values->payload_size[i][j] = value_len;
+	}
+
+	return 0;
+}
+
 /*
- * Scan the VPD for WiFi calibration data, checking for all possible key names
- * and caching discovered blobs.
+ * Scan the VPD once for WiFi calibration data, collecting all possible key
+ * names, and cache discovered blobs.
  *
  * Return the sum of sizes of all blobs, as stored in CBMEM.
  */
@@ -91,7 +124,10 @@ static size_t fill_up_entries_cache(struct vpd_blob_cache_t *cache,
 	int i;
 	int cbmem_entry_size = 0;
 	size_t used_entries = 0;
+	struct calibration_values values;
 
+	memset(&values, 0, sizeof(values));
+	cros_vpd_foreach(find_calibration_key, &values);
 
 	for (i = 0;
 	     (i < ARRAY_SIZE(templates)) && (used_entries < max_entries);
@@ -112,7 +148,8 @@ static size_t fill_up_entries_cache(struct vpd_blob_cache_t *cache,
 			strcpy(cache->key_name, templates[i]);
 			cache->key_name[index_location] = j + '0';
 
-			payload = cros_vpd_find(cache->key_name, &payload_size);
+			payload = values.payload[i][j];
+			payload_size = values.payload_size[i][j];
 			if (!payload)
 				continue;
 
@@ -31,6 +31,7 @@
 #include "partitioned_file.h"
 #include <commonlib/fsp.h>
 #include <commonlib/endian.h>
+#include <commonlib/microcode_index.h>
 
 #define SECTION_WITH_FIT_TABLE	"BOOTBLOCK"
 
@@ -1051,6 +1052,49 @@ static int cbfs_read(void)
 	return buffer_write_file(param.image_region, param.filename);
 }
 
+static int cbfs_add_microcode_index(void)
+{
+	struct cbfs_image image;
+	struct cbfs_file *header = NULL;
+	struct buffer index;
+	int ret = 1;
+
+	if (!param.name) {
+		ERROR("You need to specify -n/--name.\n");
+		return 1;
+	}
+
+	if (cbfs_image_from_buffer(&image, param.image_region,
+							param.headeroffset))
+		return 1;
+
+	if (microcode_index_create(&image, param.name, &index))
+		return 1;
+
+	/* The index is derived from the blob, so replace an old one. */
+	if (cbfs_get_entry(&image, MICROCODE_INDEX_CBFS_FILE) &&
+	    cbfs_remove_entry(&image, MICROCODE_INDEX_CBFS_FILE)) {
+		ERROR("Removing the old '%s' failed.\n",
+		      MICROCODE_INDEX_CBFS_FILE);
+		goto done;
+	}
+
+	header = cbfs_create_file_header(CBFS_COMPONENT_RAW, index.size,
+					 MICROCODE_INDEX_CBFS_FILE);
+	if (cbfs_add_entry(&image, &index, 0, header) != 0) {
+		ERROR("Failed to add '%s' into ROM image.\n",
+		      MICROCODE_INDEX_CBFS_FILE);
+		goto done;
+	}
+
+	ret = 0;
+
+done:
+	free(header);
+	buffer_delete(&index);
+	return ret;
+}
+
 static int cbfs_update_fit(void)
 {
 	if (!param.name) {
@@ -1125,6 +1169,8 @@ static const struct command commands[] = {
 				true, true},
 	{"add-int", "H:r:i:n:b:vgh?", cbfs_add_integer, true, true},
 	{"add-master-header", "H:r:vh?", cbfs_add_master_header, true, true},
+	{"add-microcode-index", "H:r:n:vh?", cbfs_add_microcode_index,
+				true, true},
 	{"compact", "r:h?", cbfs_compact, true, true},
 	{"copy", "r:R:h?", cbfs_copy, true, true},
 	{"create", "M:r:s:B:b:H:o:m:vh?", cbfs_create, true, true},
@@ -1260,6 +1306,9 @@ static void usage(char *name)
 			"Add a raw 64-bit integer value\n"
 	     " add-master-header [-r image,regions]                        "
 			"Add a legacy CBFS master header\n"
+	     " add-microcode-index [-r image,regions] \\\n"
+	     "        -n MICROCODE_BLOB_NAME                               "
+			"Add an index of the microcode updates\n"
 	     " remove [-r image,regions] -n NAME                           "
 			"Remove a component\n"
 	     " compact -r image,regions                                    "
@@ -17,6 +17,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <commonlib/endian.h>
+#include <commonlib/microcode_index.h>
 
 #include "fit.h"
 
@@ -295,3 +297,70 @@ out:
 	free(mcus);
 	return ret;
 }
+
+int microcode_index_create(struct cbfs_image *image,
+			   const char *microcode_blob_name, struct buffer *index)
+{
+	struct cbfs_file *mcode_file;
+	const struct microcode_header *mcu_header;
+	uint32_t current_offset, file_length, offset, num_entries;
+	uint8_t *entry;
+
+	mcode_file = cbfs_get_entry(image, microcode_blob_name);
+	if (!mcode_file) {
+		ERROR("File '%s' not found in CBFS.\n", microcode_blob_name);
+		return 1;
+	}
+
+	fit_header(mcode_file, &current_offset, &file_length);
+	current_offset += (int)((char *)mcode_file - image->buffer.data);
+
+	if (buffer_create(index, sizeof(struct microcode_index_header) +
+			  file_length / sizeof(*mcu_header) *
+			  sizeof(struct microcode_index_entry), "index"))
+		return 1;
+
+	entry = (uint8_t *)buffer_get(index) +
+		sizeof(struct microcode_index_header);
+	num_entries = 0;
+
+	/* Walk the blob the same way intel_microcode_find() does. */
+	for (offset = 0; file_length - offset >= sizeof(*mcu_header);) {
+		uint32_t update_size;
+
+		mcu_header = rom_buffer_pointer(&image->buffer,
+						current_offset + offset);
+
+		update_size = mcu_header->total_size;
+		if (update_size == 0)
+			update_size = 2048;
+
+		/* Stop at padding or anything else that isn't an update. */
+		if (mcu_header->version != 1 ||
+		    update_size < sizeof(*mcu_header) ||
+		    update_size > file_length - offset)
+			break;
+
+		write_le32(entry, mcu_header->processor_signature);
+		write_le32(entry + 4, mcu_header->processor_flags);
+		write_le32(entry + 8, offset);
+		write_le32(entry + 12, update_size);
+		entry += sizeof(struct microcode_index_entry);
+		num_entries++;
+
+		offset += update_size;
+	}
+
+	entry = (uint8_t *)buffer_get(index);
+	write_le32(entry, MICROCODE_INDEX_MAGIC);
+	write_le32(entry + 4, file_length);
+	write_le32(entry + 8, num_entries);
+	write_le32(entry + 12, offset);
+	buffer_set_size(index, sizeof(struct microcode_index_header) +
+			num_entries * sizeof(struct microcode_index_entry));
+
+	INFO("Indexed %u microcode updates in '%s'.\n", num_entries,
+	     microcode_blob_name);
+
+	return 0;
+}
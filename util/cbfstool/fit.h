@@ -31,4 +31,11 @@ typedef unsigned (*fit_offset_converter_t)(const struct buffer *region,
 int fit_update_table(struct buffer *bootblock, struct cbfs_image *image,
 		     const char *microcode_blob_name, int empty_entries,
 		     fit_offset_converter_t offset_fn);
+
+/*
+ * Create the index of the Intel microcode updates in the named blob as
+ * described in commonlib/microcode_index.h. Returns 0 on success.
+ */
+int microcode_index_create(struct cbfs_image *image,
+			   const char *microcode_blob_name, struct buffer *index);
 #endif
@@ -424,6 +424,60 @@ add_section(struct elf_writer *ew, struct buffer *data, const char *name,
 	return ret;
 }
 
+static void put_uleb128(uint8_t *out, size_t *len, Elf64_Xword val)
+{
+	do {
+		uint8_t b = val & 0x7f;
+
+		val >>= 7;
+		if (val)
+			b |= 0x80;
+		if (out != NULL)
+			out[*len] = b;
+		(*len)++;
+	} while (val);
+}
+
+/*
+ * Encode the relocations as runs of consecutive slots (RMODULE_VERSION_2)
+ * into out, or only count the bytes needed if out is NULL. Returns the size
+ * of the encoding, < 0 if the relocations can't be encoded that way.
+ */
+static ssize_t encode_reloc_runs(const struct rmod_context *ctx,
+				 size_t slot_size, uint8_t *out)
+{
+	const Elf64_Addr begin = ctx->phdr->p_vaddr;
+	const Elf64_Addr end = begin + ctx->phdr->p_filesz;
+	Elf64_Addr prev_end = 0;
+	Elf64_Xword i, j;
+	size_t len = 0;
+
+	for (i = 0; i < ctx->nrelocs; i = j) {
+		const Elf64_Addr start = ctx->emitted_relocs[i];
+		Elf64_Xword count;
+
+		/* Runs need to be sorted, distinct and inside the payload. */
+		if (start < prev_end || start < begin ||
+		    start + slot_size > end)
+			return -1;
+
+		for (j = i + 1; j < ctx->nrelocs; j++) {
+			if (ctx->emitted_relocs[j] !=
+			    start + (j - i) * slot_size)
+				break;
+		}
+		count = j - i;
+
+		put_uleb128(out, &len, ((start - prev_end) << 1) | (count > 1));
+		if (count > 1)
+			put_uleb128(out, &len, count - 2);
+
+		prev_end = start + count * slot_size;
+	}
+
+	return len;
+}
+
 static int
 write_elf(const struct rmod_context *ctx, const struct buffer *in,
           struct buffer *out)
@@ -440,9 +494,27 @@ write_elf(const struct rmod_context *ctx, const struct buffer *in,
 	Elf64_Xword total_size;
 	Elf64_Addr addr;
 	Elf64_Ehdr ehdr;
+	ssize_t runs_size;
+	size_t relocs_size;
 
 	bit64 = ctx->pelf.ehdr.e_ident[EI_CLASS] == ELFCLASS64;
 
+	/* Prefer the compact relocation runs, fall back to the plain array
+	 * of relocation addresses. */
+	if (bit64)
+		relocs_size = ctx->nrelocs * sizeof(Elf64_Addr);
+	else
+		relocs_size = ctx->nrelocs * sizeof(Elf32_Addr);
+	runs_size = encode_reloc_runs(ctx, bit64 ? sizeof(Elf64_Addr) :
+				      sizeof(Elf32_Addr), NULL);
+	if (runs_size >= 0) {
+		INFO("%zu bytes of relocation runs instead of %zu.\n",
+		     (size_t)runs_size, relocs_size);
+		relocs_size = runs_size;
+	} else {
+		WARN("Relocations can't be encoded as runs.\n");
+	}
+
 	/*
 	 * 3 sections will be added  to the ELF file.
 	 * +------------------+
@@ -455,11 +527,7 @@ write_elf(const struct rmod_context *ctx, const struct buffer *in,
 	 */
 
 	/* Create buffer for header and relocations. */
-	rmod_data_size = sizeof(struct rmodule_header);
-	if (bit64)
-		rmod_data_size += ctx->nrelocs * sizeof(Elf64_Addr);
-	else
-		rmod_data_size += ctx->nrelocs * sizeof(Elf32_Addr);
+	rmod_data_size = sizeof(struct rmodule_header) + relocs_size;
 
 	if (buffer_create(&rmod_data, rmod_data_size, "rmod"))
 		return -1;
@@ -488,7 +556,8 @@ write_elf(const struct rmod_context *ctx, const struct buffer *in,
 
 	/* Write out rmodule_header. */
 	ctx->xdr->put16(&rmod_header, RMODULE_MAGIC);
-	ctx->xdr->put8(&rmod_header, RMODULE_VERSION_1);
+	ctx->xdr->put8(&rmod_header, runs_size >= 0 ? RMODULE_VERSION_2 :
+		       RMODULE_VERSION_1);
 	ctx->xdr->put8(&rmod_header, 0);
 	/* payload_begin_offset */
 	loc = sizeof(struct rmodule_header);
@@ -499,10 +568,7 @@ write_elf(const struct rmod_context *ctx, const struct buffer *in,
 	/* relocations_begin_offset */
 	ctx->xdr->put32(&rmod_header, loc);
 	/* relocations_end_offset */
-	if (bit64)
-		loc += ctx->nrelocs * sizeof(Elf64_Addr);
-	else
-		loc += ctx->nrelocs * sizeof(Elf32_Addr);
+	loc += relocs_size;
 	ctx->xdr->put32(&rmod_header, loc);
 	/* module_link_start_address */
 	ctx->xdr->put32(&rmod_header, ctx->phdr->p_vaddr);
@@ -525,11 +591,20 @@ write_elf(const struct rmod_context *ctx, const struct buffer *in,
 	ctx->xdr->put32(&rmod_header, 0);
 
 	/* Write the relocations. */
-	for (unsigned i = 0; i < ctx->nrelocs; i++) {
-		if (bit64)
-			ctx->xdr->put64(&relocs, ctx->emitted_relocs[i]);
-		else
-			ctx->xdr->put32(&relocs, ctx->emitted_relocs[i]);
+	if (runs_size >= 0) {
+		encode_reloc_runs(ctx, bit64 ? sizeof(Elf64_Addr) :
+				  sizeof(Elf32_Addr),
+				  (uint8_t *)buffer_get(&relocs));
+		buffer_set_size(&relocs, runs_size);
+	} else {
+		for (unsigned i = 0; i < ctx->nrelocs; i++) {
+			if (bit64)
+				ctx->xdr->put64(&relocs,
+						ctx->emitted_relocs[i]);
+			else
+				ctx->xdr->put32(&relocs,
+						ctx->emitted_relocs[i]);
+		}
 	}
 
 	total_size = 0;
@@ -720,7 +795,8 @@ int rmodule_stage_to_elf(Elf64_Ehdr *ehdr, struct buffer *buff)
 	/* Indicate that file is not an rmodule if initial checks fail. */
 	if (rmod.magic != RMODULE_MAGIC)
 		return 1;
-	if (rmod.version != RMODULE_VERSION_1)
+	if (rmod.version != RMODULE_VERSION_1 &&
+	    rmod.version != RMODULE_VERSION_2)
 		return 1;
 
 	if (rmod.payload_begin_offset > input_sz ||
@@ -807,6 +883,35 @@ int rmodule_stage_to_elf(Elf64_Ehdr *ehdr, struct buffer *buff)
 	ssize_t relocs_sz = rmod.relocations_end_offset;
 	relocs_sz -= rmod.relocations_begin_offset;
 	buffer_splice(&reader, buff, rmod.relocations_begin_offset, relocs_sz);
+
+	if (rmod.version == RMODULE_VERSION_2) {
+		const uint8_t *p = (const uint8_t *)buffer_get(&reader);
+		const uint8_t *end = p + relocs_sz;
+		const size_t slot_size = bit64 ? sizeof(Elf64_Addr) :
+					 sizeof(Elf32_Addr);
+		Elf64_Addr addr = 0;
+
+		relocs_sz = 0;
+		while (p < end) {
+			size_t distance, count;
+
+			if (rmodule_get_reloc_run(&p, end, &distance, &count)) {
+				ERROR("Malformed relocation runs.\n");
+				elf_writer_destroy(ew);
+				return -1;
+			}
+
+			for (addr += distance; count > 0; count--) {
+				if (elf_writer_add_rel(ew, section_name, addr)) {
+					ERROR("Relocation addition failure.\n");
+					elf_writer_destroy(ew);
+					return -1;
+				}
+				addr += slot_size;
+			}
+		}
+	}
+
 	while (relocs_sz > 0) {
 		Elf64_Addr addr;
 
@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <commonlib/cbmem_id.h>
 #include <commonlib/timestamp_serialized.h>
+#include <commonlib/mp_timing_serialized.h>
 #include <commonlib/coreboot_tables.h>
 
 #ifdef __OpenBSD__
@@ -601,6 +602,55 @@ static void dump_timestamps(int mach_readable)
 	unmap_memory();
 }
 
+/* dump the per CPU times of the MP initialization */
+static void dump_mp_timing(void)
+{
+	struct mp_timing *t;
+	uint64_t start;
+	size_t size;
+	uint32_t i;
+
+	if (find_cbmem_entry(CBMEM_ID_MP_TIMING, &start, &size) ||
+	    size < sizeof(*t)) {
+		fprintf(stderr, "No MP timing found\n");
+		return;
+	}
+
+	t = map_memory_size(start, size, 1);
+	if (t->num_cpus > (size - sizeof(*t)) / sizeof(t->cpus[0])) {
+		fprintf(stderr, "Invalid MP timing table\n");
+		unmap_memory();
+		return;
+	}
+
+	timestamp_set_tick_freq(t->tick_freq_mhz);
+
+	printf("%u CPUs, all done ", t->num_cpus);
+	print_norm(arch_convert_raw_ts_entry(t->done - t->sipi));
+	printf(" us after SIPI\n\n");
+
+	for (i = 0; i < t->num_cpus; i++) {
+		const struct mp_cpu_timing *c = &t->cpus[i];
+
+		printf("CPU %3u, APIC ID %3u: ", i, c->apic_id);
+		if (c->init_done == 0) {
+			printf("never checked in\n");
+			continue;
+		}
+		/* The BSP doesn't enter ap_init(). */
+		if (c->entry) {
+			printf("entry ");
+			print_norm(arch_convert_raw_ts_entry(c->entry - t->sipi));
+			printf(" us, ");
+		}
+		printf("initialized ");
+		print_norm(arch_convert_raw_ts_entry(c->init_done - t->sipi));
+		printf(" us\n");
+	}
+
+	unmap_memory();
+}
+
 struct cbmem_console {
 	u32 size;
 	u32 cursor;
@@ -933,7 +983,7 @@ static void print_version(void)
 
 static void print_usage(const char *name, int exit_code)
 {
-	printf("usage: %s [-cCltTxVvh?]\n", name);
+	printf("usage: %s [-cCltTmxVvh?]\n", name);
 	printf("\n"
 	     "   -c | --console:                   print cbmem console\n"
 	     "   -C | --coverage:                  dump coverage information\n"
@@ -942,6 +992,7 @@ static void print_usage(const char *name, int exit_code)
 	     "   -r | --rawdump ID:                print rawdump of specific ID (in hex) of cbtable\n"
 	     "   -t | --timestamps:                print timestamp information\n"
 	     "   -T | --parseable-timestamps:      print parseable timestamps\n"
+	     "   -m | --mp-timing:                 print MP initialization times\n"
 	     "   -V | --verbose:                   verbose (debugging) output\n"
 	     "   -v | --version:                   print the version\n"
 	     "   -h | --help:                      print this help\n"
@@ -1074,6 +1125,7 @@ int main(int argc, char** argv)
 	int print_rawdump = 0;
 	int print_timestamps = 0;
 	int machine_readable_timestamps = 0;
+	int print_mp_timing = 0;
 	unsigned int rawdump_id = 0;
 
 	int opt, option_index = 0;
@@ -1083,6 +1135,7 @@ int main(int argc, char** argv)
 		{"list", 0, 0, 'l'},
 		{"timestamps", 0, 0, 't'},
 		{"parseable-timestamps", 0, 0, 'T'},
+		{"mp-timing", 0, 0, 'm'},
 		{"hexdump", 0, 0, 'x'},
 		{"rawdump", required_argument, 0, 'r'},
 		{"verbose", 0, 0, 'V'},
@@ -1090,7 +1143,7 @@ int main(int argc, char** argv)
 		{"help", 0, 0, 'h'},
 		{0, 0, 0, 0}
 	};
-	while ((opt = getopt_long(argc, argv, "cCltTxVvh?r:",
+	while ((opt = getopt_long(argc, argv, "cCltTmxVvh?r:",
 				  long_options, &option_index)) != EOF) {
 		switch (opt) {
 		case 'c':
@@ -1123,6 +1176,10 @@ int main(int argc, char** argv)
 			machine_readable_timestamps = 1;
 			print_defaults = 0;
 			break;
+		case 'm':
+			print_mp_timing = 1;
+			print_defaults = 0;
+			break;
 		case 'V':
 			verbose = 1;
 			break;
@@ -1228,6 +1285,9 @@ int main(int argc, char** argv)
 	if (print_defaults || print_timestamps)
 		dump_timestamps(machine_readable_timestamps);
 
+	if (print_mp_timing)
+		dump_mp_timing();
+
 	close(mem_fd);
 	return 0;
 }
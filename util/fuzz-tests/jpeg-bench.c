@@ -0,0 +1,94 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Throughput benchmark for the splash screen decoder.
+ *
+ * usage: jpeg-bench <file.jpg> [iterations]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "jpeg.h"
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+	static const int depths[] = { 16, 24, 32 };
+	FILE *f;
+	unsigned long len;
+	int iterations = 100;
+	int width, height, d, scale, i, ret;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <file.jpg> [iterations]\n", argv[0]);
+		return 1;
+	}
+	if (argc > 2)
+		iterations = atoi(argv[2]);
+
+	f = fopen(argv[1], "rb");
+	if (!f)
+		return 1;
+	if (fseek(f, 0, SEEK_END) != 0)
+		return 1;
+	len = ftell(f);
+	if (fseek(f, 0, SEEK_SET) != 0)
+		return 1;
+
+	unsigned char *buf = malloc(len);
+	struct jpeg_decdata *decdata = malloc(sizeof(*decdata));
+	if (fread(buf, len, 1, f) != 1)
+		return 1;
+	fclose(f);
+
+	jpeg_fetch_size(buf, &width, &height);
+	width = (width + 15) & ~15;
+	height = (height + 15) & ~15;
+	unsigned char *pic = malloc(4 * width * height);
+
+	printf("%s: %dx%d, %lu bytes, %d iterations\n", argv[1], width,
+	       height, len, iterations);
+	for (d = 0; d < sizeof(depths) / sizeof(depths[0]); d++) {
+		for (scale = 1; scale <= 8; scale <<= 1) {
+			const int bpl = width / scale * (depths[d] / 8);
+			double start = now(), elapsed;
+
+			for (i = 0; i < iterations; i++) {
+				ret = jpeg_decode_scaled(buf, pic, width,
+					height, depths[d], bpl, scale,
+					decdata);
+				if (ret) {
+					printf("decode failed: %d\n", ret);
+					return ret;
+				}
+			}
+			elapsed = now() - start;
+			printf("depth %2d scale 1/%d: %8.3f ms/image, "
+			       "%8.2f Mpixel/s\n", depths[d], scale,
+			       elapsed * 1000 / iterations,
+			       (double)width * height * iterations
+			       / elapsed / 1e6);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,215 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Host benchmark for the device lookups in src/device/device_util.c.
+ *
+ * Links against the static.c sconfig generates for a mainboard, see
+ * Makefile. Buses behind PCI bridges are numbered depth first like PCI
+ * enumeration does, and further PCI devices are appended to all_devices the
+ * way alloc_dev() adds the ones enumeration finds. Then every PCI device is
+ * looked up by bus and devfn with dev_find_slot() and by its IDs with
+ * dev_find_device(), and lookups of devices that don't exist are timed, as
+ * they walk the whole list.
+ *
+ * usage: devtree-bench [dynamic devices]
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include <console/console.h>
+#include <device/device.h>
+#include <device/path.h>
+#include <device/pci_def.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern DEVTREE_CONST struct device dev_root;
+extern DEVTREE_CONST struct device * DEVTREE_CONST last_dev;
+
+/* What the rest of ramstage would provide. */
+struct device *all_devices = &dev_root;
+struct resource *free_resources;
+struct device_operations default_dev_ops_root;
+const char mainboard_name[] = "devtree-bench";
+
+int do_printk(int msg_level, const char *fmt, ...)
+{
+	return 0;
+}
+
+void die(const char *msg)
+{
+	printf("%s", msg);
+	__builtin_trap();
+}
+
+static void *zalloc(size_t size)
+{
+	void *p = malloc(size);
+
+	memset(p, 0, size);
+	return p;
+}
+
+static unsigned int next_bus;
+
+/* Number the buses below PCI bridges depth first like pci_scan_bridge(). */
+static void number_buses(struct device *dev)
+{
+	struct bus *link;
+	struct device *child;
+
+	for (link = dev->link_list; link; link = link->next) {
+		if (dev->path.type == DEVICE_PATH_PCI)
+			link->secondary = ++next_bus;
+		for (child = link->children; child; child = child->sibling)
+			number_buses(child);
+	}
+}
+
+static unsigned int num_devices(void)
+{
+	struct device *dev;
+	unsigned int n = 0;
+
+	for (dev = all_devices; dev; dev = dev->next)
+		n++;
+	return n;
+}
+
+/* Append PCI devices on buses of their own, as found behind bridges. */
+static void add_dynamic_devices(unsigned int count)
+{
+	struct device *tail = (struct device *)last_dev;
+	struct device *dev;
+	struct bus *bus;
+	unsigned int i;
+
+	for (i = 0; i < count; i++) {
+		dev = zalloc(sizeof(*dev));
+		bus = zalloc(sizeof(*bus));
+		bus->secondary = ++next_bus;
+		bus->dev = dev;
+		dev->bus = bus;
+		dev->path.type = DEVICE_PATH_PCI;
+		dev->path.pci.devfn = PCI_DEVFN(i % 32, 0);
+		dev->enabled = 1;
+		tail->next = dev;
+		tail = dev;
+	}
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+struct lookup {
+	unsigned int bus;
+	unsigned int devfn;
+	u16 vendor;
+	u16 device;
+	struct device *dev;
+};
+
+#define ITERATIONS	20000
+
+static int bench(unsigned int dynamic)
+{
+	struct lookup *lookups;
+	struct device *dev;
+	unsigned int n = 0, i, it, pci = 0;
+	double t, slot_ns, id_ns, miss_ns;
+	volatile uintptr_t sink = 0;
+
+	add_dynamic_devices(dynamic);
+
+	for (dev = all_devices; dev; dev = dev->next)
+		if (dev->path.type == DEVICE_PATH_PCI)
+			pci++;
+	lookups = zalloc(pci * sizeof(*lookups));
+
+	for (dev = all_devices; dev; dev = dev->next) {
+		if (dev->path.type != DEVICE_PATH_PCI)
+			continue;
+		dev->vendor = 0x1022;
+		dev->device = 0x1000 + n;
+		lookups[n].bus = dev->bus->secondary;
+		lookups[n].devfn = dev->path.pci.devfn;
+		lookups[n].vendor = dev->vendor;
+		lookups[n].device = dev->device;
+		lookups[n].dev = dev;
+		n++;
+	}
+
+	/* Make sure the lookups find what they are timed on. */
+	for (i = 0; i < n; i++) {
+		dev = dev_find_slot(lookups[i].bus, lookups[i].devfn);
+		if (dev == NULL || dev->bus->secondary != lookups[i].bus ||
+		    dev->path.pci.devfn != lookups[i].devfn ||
+		    dev_find_device(lookups[i].vendor, lookups[i].device,
+				    NULL) != lookups[i].dev) {
+			printf("lookup of device %u failed\n", i);
+			return 1;
+		}
+	}
+
+	t = now();
+	for (it = 0; it < ITERATIONS; it++)
+		for (i = 0; i < n; i++)
+			sink += (uintptr_t)dev_find_slot(lookups[i].bus,
+							 lookups[i].devfn);
+	slot_ns = (now() - t) * 1e9 / ITERATIONS / n;
+
+	t = now();
+	for (it = 0; it < ITERATIONS; it++)
+		for (i = 0; i < n; i++)
+			sink += (uintptr_t)dev_find_device(lookups[i].vendor,
+							   lookups[i].device,
+							   NULL);
+	id_ns = (now() - t) * 1e9 / ITERATIONS / n;
+
+	t = now();
+	for (it = 0; it < ITERATIONS; it++)
+		for (i = 0; i < n; i++)
+			sink += (uintptr_t)dev_find_slot(0xff, lookups[i].devfn);
+	miss_ns = (now() - t) * 1e9 / ITERATIONS / n;
+
+	printf("%4u devices (%3u PCI): dev_find_slot %6.1f ns, "
+	       "dev_find_device %6.1f ns, miss %6.1f ns\n",
+	       num_devices(), n, slot_ns, id_ns, miss_ns);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int dynamic = 0;
+
+	if (argc > 1 && sscanf(argv[1], "%u", &dynamic) != 1) {
+		printf("usage: %s [dynamic devices]\n", argv[0]);
+		return 1;
+	}
+
+	number_buses(all_devices);
+	if (bench(0))
+		return 1;
+	if (dynamic && bench(dynamic))
+		return 1;
+
+	return 0;
+}
@@ -0,0 +1,274 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Randomized test and benchmark for src/lib/memrange.c.
+ *
+ * The first part runs random insert/hole/fill/update operations on a
+ * small address space and checks every result against a page map. The
+ * second part times workloads of growing size and prints a digest of
+ * the resulting ranges to stdout, timings go to stderr. `make memrange`
+ * builds this with and without CONFIG_MEMRANGE_TREE and compares the
+ * digests of both.
+ *
+ * usage: memrange-test [seed]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <console/console.h>
+#include <memrange.h>
+
+#define PAGE		4096
+#define CHECK_PAGES	512
+#define NO_TAG		(~0UL)
+
+int console_loglevel = BIOS_ERR;
+
+static unsigned long long rng_state;
+
+static unsigned long long rng(void)
+{
+	/* xorshift64* */
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return rng_state * 2685821657736338717ULL;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* memranges_add_resources() walks the device tree through this. */
+static struct resource *resources;
+static size_t num_resources;
+
+void search_global_resources(unsigned long type_mask, unsigned long type,
+			     resource_search_t search, void *gp)
+{
+	size_t i;
+
+	for (i = 0; i < num_resources; i++) {
+		if ((resources[i].flags & type_mask) == type)
+			search(gp, NULL, &resources[i]);
+	}
+}
+
+static unsigned long model[CHECK_PAGES];
+
+static void model_set(size_t first, size_t count, unsigned long tag)
+{
+	size_t i;
+
+	for (i = first; i < first + count && i < CHECK_PAGES; i++)
+		model[i] = tag;
+}
+
+static void model_fill_holes(size_t limit, unsigned long tag)
+{
+	size_t i;
+
+	/* Nothing is added in front of the first entry. */
+	for (i = 0; i < CHECK_PAGES && model[i] == NO_TAG; i++)
+		;
+	for (; i < limit; i++) {
+		if (model[i] == NO_TAG)
+			model[i] = tag;
+	}
+}
+
+static void model_update_tag(unsigned long old_tag, unsigned long new_tag)
+{
+	size_t i;
+
+	for (i = 0; i < CHECK_PAGES; i++) {
+		if (model[i] == old_tag)
+			model[i] = new_tag;
+	}
+}
+
+static int check(struct memranges *ranges, int step)
+{
+	unsigned long seen[CHECK_PAGES];
+	const struct range_entry *r, *prev = NULL;
+	resource_t addr;
+	size_t i;
+
+	for (i = 0; i < CHECK_PAGES; i++)
+		seen[i] = NO_TAG;
+
+	memranges_each_entry(r, ranges) {
+		if (range_entry_base(r) >= range_entry_end(r) ||
+		    range_entry_end(r) > CHECK_PAGES * PAGE) {
+			printf("step %d: bad entry [%llx, %llx)\n", step,
+			       (unsigned long long)range_entry_base(r),
+			       (unsigned long long)range_entry_end(r));
+			return -1;
+		}
+		if (prev != NULL &&
+		    (range_entry_end(prev) > range_entry_base(r) ||
+		     (range_entry_end(prev) == range_entry_base(r) &&
+		      range_entry_tag(prev) == range_entry_tag(r)))) {
+			printf("step %d: unsorted or unmerged entries\n", step);
+			return -1;
+		}
+		for (addr = range_entry_base(r); addr < range_entry_end(r);
+		     addr += PAGE)
+			seen[addr / PAGE] = range_entry_tag(r);
+		prev = r;
+	}
+
+	for (i = 0; i < CHECK_PAGES; i++) {
+		r = memranges_find_entry(ranges, i * PAGE + 123);
+		if (seen[i] != model[i] ||
+		    (r ? range_entry_tag(r) : NO_TAG) != model[i]) {
+			printf("step %d: page %zu is %ld, expected %ld\n",
+			       step, i, (long)seen[i], (long)model[i]);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int random_check(int steps)
+{
+	struct memranges ranges;
+	int step;
+
+	memranges_init_empty(&ranges, NULL, 0);
+	model_set(0, CHECK_PAGES, NO_TAG);
+
+	for (step = 0; step < steps; step++) {
+		const size_t first = rng() % CHECK_PAGES;
+		const size_t count = 1 + rng() % (1 + (CHECK_PAGES - first) / 8);
+		const unsigned long tag = rng() % 4;
+		const int op = rng() % 16;
+
+		if (op < 10) {
+			memranges_insert(&ranges, first * PAGE, count * PAGE,
+					 tag);
+			model_set(first, count, tag);
+		} else if (op < 14) {
+			memranges_create_hole(&ranges, first * PAGE,
+					      count * PAGE);
+			model_set(first, count, NO_TAG);
+		} else if (op < 15) {
+			memranges_fill_holes_up_to(&ranges, first * PAGE, tag);
+			model_fill_holes(first, tag);
+		} else {
+			const unsigned long new_tag = rng() % 4;
+
+			memranges_update_tag(&ranges, tag, new_tag);
+			model_update_tag(tag, new_tag);
+		}
+
+		if (check(&ranges, step))
+			return -1;
+
+		if (rng() % 256 == 0) {
+			memranges_teardown(&ranges);
+			model_set(0, CHECK_PAGES, NO_TAG);
+		}
+	}
+
+	memranges_teardown(&ranges);
+	return 0;
+}
+
+/* Roughly what bootmem and MTRR setup do: add all device resources,
+ * punch some reserved holes and fill the rest of the address space. */
+static void workload(size_t n)
+{
+	struct memranges ranges;
+	const struct range_entry *r;
+	unsigned long long digest = 1469598103934665603ULL;
+	size_t count = 0, i;
+	double start, t_add, t_hole, t_fill, t_find;
+	volatile unsigned long sink = 0;
+
+	resources = malloc(n * sizeof(*resources));
+	for (i = 0; i < n; i++) {
+		resources[i].base = (rng() % (1ULL << 28)) * PAGE;
+		resources[i].size = (1 + rng() % 64) * PAGE;
+		resources[i].flags = IORESOURCE_MEM | (rng() % 4);
+	}
+	num_resources = n;
+
+	memranges_init_empty(&ranges, NULL, 0);
+
+	start = now();
+	for (i = 0; i < 4; i++)
+		memranges_add_resources(&ranges, 3, i, i + 1);
+	t_add = now() - start;
+
+	start = now();
+	for (i = 0; i < n / 4; i++)
+		memranges_create_hole(&ranges, (rng() % (1ULL << 28)) * PAGE,
+				      (1 + rng() % 16) * PAGE);
+	t_hole = now() - start;
+
+	start = now();
+	memranges_fill_holes_up_to(&ranges, 1ULL << 41, 5);
+	t_fill = now() - start;
+
+	start = now();
+	for (i = 0; i < n; i++) {
+		r = memranges_find_entry(&ranges, rng() % (1ULL << 40));
+		sink += r ? range_entry_tag(r) : 0;
+	}
+	t_find = now() - start;
+
+	memranges_each_entry(r, &ranges) {
+		digest = (digest ^ range_entry_base(r)) * 1099511628211ULL;
+		digest = (digest ^ range_entry_end(r)) * 1099511628211ULL;
+		digest = (digest ^ range_entry_tag(r)) * 1099511628211ULL;
+		count++;
+	}
+
+	printf("%6zu resources: %6zu entries, digest %016llx\n",
+	       n, count, digest);
+	fprintf(stderr, "%6zu resources: add %8.3f ms, hole %8.3f ms, "
+		"fill %8.3f ms, find %8.3f ms\n", n, t_add * 1e3,
+		t_hole * 1e3, t_fill * 1e3, t_find * 1e3);
+
+	memranges_teardown(&ranges);
+	free(resources);
+}
+
+int main(int argc, char **argv)
+{
+	size_t n;
+
+	rng_state = argc > 1 ? strtoull(argv[1], NULL, 0) : 1;
+	if (rng_state == 0)
+		rng_state = 1;
+
+	fprintf(stderr, "memrange tree index: %s\n",
+		IS_ENABLED(CONFIG_MEMRANGE_TREE) ? "yes" : "no");
+
+	if (random_check(20000))
+		return 1;
+	printf("random check passed\n");
+
+	for (n = 64; n <= 16384; n *= 4)
+		workload(n);
+
+	return 0;
+}
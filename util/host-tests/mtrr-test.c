@@ -0,0 +1,379 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Host harness for the variable MTRR solver in src/cpu/x86/mtrr/mtrr.c.
+ *
+ * Reads a physical address space in the format coreboot prints it
+ * ("MTRR: Physical address space:" in the ramstage log), runs the MTRR
+ * setup on it, checks that the programmed MTRRs give every range its
+ * type and compares the number of MTRRs with the per-range layouts used
+ * before the solver.
+ *
+ * usage: mtrr-test [-v] [-a address bits] [-n variable MTRRs] <map>...
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "../../src/cpu/x86/mtrr/mtrr.c"
+
+int console_loglevel = BIOS_WARNING;
+
+static int phys_address_bits = 39;
+static int var_mtrr_cap = 10;
+
+int cpu_phys_address_size(void)
+{
+	return phys_address_bits;
+}
+
+static msr_t msrs[0x300];
+
+msr_t rdmsr(unsigned int index)
+{
+	if (index == MTRR_CAP_MSR)
+		return (msr_t){ .lo = var_mtrr_cap, .hi = 0 };
+	return msrs[index];
+}
+
+void wrmsr(unsigned int index, msr_t msr)
+{
+	msrs[index] = msr;
+}
+
+#define MAX_RANGES 256
+
+static struct device vga = {
+	.path = { .type = DEVICE_PATH_PCI },
+	.class = PCI_CLASS_DISPLAY_VGA << 8,
+};
+static struct device other = {
+	.path = { .type = DEVICE_PATH_PCI },
+};
+static struct resource resources[MAX_RANGES];
+static size_t num_resources;
+
+void search_global_resources(unsigned long type_mask, unsigned long type,
+			     resource_search_t search, void *gp)
+{
+	size_t i;
+
+	for (i = 0; i < num_resources; i++) {
+		struct resource *res = &resources[i];
+
+		if ((res->flags & type_mask) != type)
+			continue;
+		search(gp, (res->flags & IORESOURCE_PREFETCH) ? &vga : &other,
+		       res);
+	}
+}
+
+static int read_map(const char *path)
+{
+	unsigned long long begin, end, size;
+	char line[256];
+	FILE *f;
+	int type;
+
+	f = fopen(path, "r");
+	if (f == NULL) {
+		perror(path);
+		return -1;
+	}
+
+	num_resources = 0;
+	while (fgets(line, sizeof(line), f) != NULL) {
+		const char *p = strstr(line, "0x");
+		struct resource *res;
+
+		if (line[0] == '#' || p == NULL ||
+		    sscanf(p, "0x%llx - 0x%llx size 0x%llx type %d",
+			   &begin, &end, &size, &type) != 4)
+			continue;
+		if (num_resources == MAX_RANGES)
+			break;
+
+		res = &resources[num_resources++];
+		res->base = begin;
+		res->size = end - begin;
+		res->flags = IORESOURCE_MEM;
+		if (type == MTRR_TYPE_WRBACK)
+			res->flags |= IORESOURCE_CACHEABLE;
+		else if (type == MTRR_TYPE_WRCOMB)
+			res->flags |= IORESOURCE_PREFETCH;
+	}
+
+	fclose(f);
+	return 0;
+}
+
+/*
+ * The per-range layouts that were tried before the solver: each range
+ * covered on its own, with UC as default type optionally with a hole
+ * carved out up to the next 64MiB boundary.
+ */
+#define LEGACY_MIN_ALIGN PHYS_TO_RANGE_ADDR(64 << 20)
+
+static int legacy_without_hole(struct range_entry *r)
+{
+	uint32_t a1, a2, b1, b2, c1, c2;
+
+	a1 = range_entry_base_mtrr_addr(r);
+	c2 = range_entry_end_mtrr_addr(r);
+	if (c2 <= RANGE_1MB)
+		return 0;
+	if (a1 <= RANGE_1MB)
+		a1 = 0;
+	if ((c2 - a1) < LEGACY_MIN_ALIGN)
+		return var_mtrr_count(a1, c2 - a1);
+
+	b1 = a2 = ALIGN_UP(a1, LEGACY_MIN_ALIGN);
+	b2 = c1 = ALIGN_DOWN(c2, LEGACY_MIN_ALIGN);
+
+	return var_mtrr_count(a1, a2 - a1) + var_mtrr_count(b1, b2 - b1) +
+		var_mtrr_count(c1, c2 - c1);
+}
+
+static int legacy_with_hole(struct memranges *addr_space,
+			    struct range_entry *r)
+{
+	struct range_entry *next;
+	uint32_t a1, a2, b1, b2;
+
+	a1 = range_entry_base_mtrr_addr(r);
+	a2 = range_entry_end_mtrr_addr(r);
+	if (a2 <= RANGE_1MB)
+		return 0;
+	if (a1 <= RANGE_1MB)
+		a1 = 0;
+
+	next = memranges_next_entry(addr_space, r);
+	b1 = a2;
+
+	if (a1 >= RANGE_4GB && next == NULL) {
+		b2 = (1 << fls(a1)) + a1;
+		if (b2 >= a2)
+			return var_mtrr_count(a1, b2 - a1);
+	}
+
+	b2 = ALIGN_UP(a2, LEGACY_MIN_ALIGN);
+	if (next != NULL &&
+	    (range_entry_mtrr_type(next) != MTRR_TYPE_UNCACHEABLE ||
+	     range_entry_end_mtrr_addr(next) < b2))
+		return var_mtrr_count(a1, a2 - a1);
+
+	return var_mtrr_count(a1, b2 - a1) + var_mtrr_count(b1, b2 - b1);
+}
+
+static void legacy_counts(struct memranges *addr_space, int wrcomb,
+			  int *wb_count, int *uc_count)
+{
+	struct range_entry *r;
+
+	*wb_count = 0;
+	*uc_count = 0;
+	memranges_each_entry(r, addr_space) {
+		int type = range_entry_mtrr_type(r);
+
+		if (!wrcomb && type == MTRR_TYPE_WRCOMB)
+			type = MTRR_TYPE_UNCACHEABLE;
+
+		if (type != MTRR_TYPE_UNCACHEABLE) {
+			const int no_hole = legacy_without_hole(r);
+			const int hole = type == MTRR_TYPE_WRBACK ?
+				legacy_with_hole(addr_space, r) : 64;
+
+			*uc_count += MIN(no_hole, hole);
+		}
+		if (type != MTRR_TYPE_WRBACK)
+			*wb_count += legacy_without_hole(r);
+	}
+}
+
+/* Effective memory type at addr according to the programmed MTRRs. */
+static int effective_type(resource_t addr)
+{
+	const msr_t def = msrs[MTRR_DEF_TYPE_MSR];
+	int type = -1;
+	int i;
+
+	for (i = 0; i < var_mtrr_cap; i++) {
+		const msr_t base = msrs[MTRR_PHYS_BASE(i)];
+		const msr_t mask = msrs[MTRR_PHYS_MASK(i)];
+		const resource_t b = ((resource_t)base.hi << 32) |
+			(base.lo & ~0xfffU);
+		const resource_t m = ((resource_t)mask.hi << 32) |
+			(mask.lo & ~0xfffU);
+		const int t = base.lo & 0xff;
+
+		if (!(mask.lo & MTRR_PHYS_MASK_VALID) || (addr & m) != (b & m))
+			continue;
+
+		if (type < 0 || t == MTRR_TYPE_UNCACHEABLE)
+			type = t;
+		else if (type != t && type != MTRR_TYPE_UNCACHEABLE) {
+			if ((type == MTRR_TYPE_WRBACK &&
+			     t == MTRR_TYPE_WRTHROUGH) ||
+			    (t == MTRR_TYPE_WRBACK &&
+			     type == MTRR_TYPE_WRTHROUGH))
+				type = MTRR_TYPE_WRTHROUGH;
+			else
+				return -1; /* undefined */
+		}
+	}
+
+	return type < 0 ? (int)(def.lo & MTRR_DEF_TYPE_MASK) : type;
+}
+
+/* Check every range and the boundaries of all MTRRs inside of it. */
+static int check_solution(struct memranges *addr_space)
+{
+	struct range_entry *r;
+	int errors = 0;
+	int i;
+
+	memranges_each_entry(r, addr_space) {
+		const resource_t begin = MAX(range_entry_base(r), 1 << 20);
+		const resource_t end = range_entry_end(r);
+		resource_t points[2 * NUM_MTRR_STATIC_STORAGE + 1];
+		int n = 0, j;
+
+		if (end <= begin)
+			continue;
+
+		points[n++] = begin;
+		for (i = 0; i < var_mtrr_cap; i++) {
+			const msr_t base = msrs[MTRR_PHYS_BASE(i)];
+			const msr_t mask = msrs[MTRR_PHYS_MASK(i)];
+			const resource_t b = ((resource_t)base.hi << 32) |
+				(base.lo & ~0xfffU);
+			const resource_t m = ((resource_t)mask.hi << 32) |
+				(mask.lo & ~0xfffU);
+			const resource_t e = b + ((~m + 1) &
+				((1ULL << phys_address_bits) - 1));
+
+			if (!(mask.lo & MTRR_PHYS_MASK_VALID))
+				continue;
+			if (b > begin && b < end)
+				points[n++] = b;
+			if (e > begin && e < end)
+				points[n++] = e;
+		}
+
+		for (j = 0; j < n; j++) {
+			const int type = effective_type(points[j]);
+
+			if (type == range_entry_mtrr_type(r))
+				continue;
+			printf("  0x%llx in [0x%llx, 0x%llx) is type %d, "
+			       "expected %d\n", (unsigned long long)points[j],
+			       (unsigned long long)range_entry_base(r),
+			       (unsigned long long)end, type,
+			       range_entry_mtrr_type(r));
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static int run(const char *path)
+{
+	struct memranges *addr_space;
+	struct range_entry *r;
+	int legacy_wb, legacy_uc, legacy_wc = 1;
+	int wb, uc, wc = 0;
+	int errors;
+
+	memset(msrs, 0, sizeof(msrs));
+	if (read_map(path))
+		return -1;
+
+	detect_var_mtrrs();
+	addr_space = get_physical_address_space();
+
+	legacy_counts(addr_space, 1, &legacy_wb, &legacy_uc);
+	if (legacy_wb > bios_mtrrs && legacy_uc > bios_mtrrs) {
+		legacy_wc = 0;
+		legacy_counts(addr_space, 0, &legacy_wb, &legacy_uc);
+	}
+
+	x86_setup_var_mtrrs(phys_address_bits, 1);
+
+	/* Recount, the setup may have turned WC ranges into UC. */
+	__calc_var_mtrrs(addr_space, 1, phys_address_bits, &wb, &uc);
+
+	memranges_each_entry(r, addr_space) {
+		if (range_entry_mtrr_type(r) == MTRR_TYPE_WRCOMB)
+			wc = 1;
+	}
+
+	printf("%s: legacy %d (WB/UC %d/%d%s), solver %d (WB/UC %d/%d%s), "
+	       "%d available\n", path, MIN(legacy_wb, legacy_uc), legacy_wb,
+	       legacy_uc, legacy_wc ? "" : ", no WC", mtrr_global_solution.num_used,
+	       wb, uc, wc ? "" : ", no WC", bios_mtrrs);
+
+	errors = check_solution(addr_space);
+	if (mtrr_global_solution.num_used > total_mtrrs) {
+		printf("  %d MTRRs needed, only %d exist\n",
+		       mtrr_global_solution.num_used, total_mtrrs);
+		errors++;
+	}
+
+	return errors ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+	int failed = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "va:n:")) != -1) {
+		switch (opt) {
+		case 'v':
+			console_loglevel = BIOS_DEBUG;
+			break;
+		case 'a':
+			phys_address_bits = atoi(optarg);
+			break;
+		case 'n':
+			var_mtrr_cap = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-v] [-a address bits] "
+				"[-n variable MTRRs] <map>...\n", argv[0]);
+			return 1;
+		}
+	}
+
+	/* The MTRR code keeps its results in static storage, so run every
+	 * map in its own process. */
+	for (; optind < argc; optind++) {
+		const pid_t pid = fork();
+		int status;
+
+		if (pid == 0)
+			return run(argv[optind]) ? 1 : 0;
+		if (pid < 0 || waitpid(pid, &status, 0) < 0 ||
+		    !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			printf("%s: FAILED\n", argv[optind]);
+			failed = 1;
+		}
+	}
+
+	return failed;
+}
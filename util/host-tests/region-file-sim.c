@@ -0,0 +1,224 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Simulation of src/lib/region_file.c on NOR flash.
+ *
+ * A region file the size of a typical RW_MRC_CACHE is updated once per
+ * simulated boot with training data that only changes every few boots, in
+ * a few bytes. The flash only allows clearing bits when programming and
+ * erases whole sectors. After every update the file is opened again and has
+ * to return the latest data. The number of writes, programmed bytes and
+ * erased sectors is printed at the end.
+ *
+ * usage: region-file-sim [data size] [boots] [change interval] [seed]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <console/console.h>
+#include <region_file.h>
+
+#define FLASH_SIZE	(64 * KiB)
+#define SECTOR_SIZE	(4 * KiB)
+
+int console_loglevel = BIOS_ERR;
+
+static uint8_t flash[FLASH_SIZE];
+
+static struct {
+	unsigned long writes;
+	unsigned long programmed;
+	unsigned long erased_sectors;
+	unsigned long bad_programs;
+} stats;
+
+static unsigned long long rng_state = 1;
+
+static unsigned long long rng(void)
+{
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return rng_state * 2685821657736338717ULL;
+}
+
+static void *nor_mmap(const struct region_device *rd, size_t offset,
+		      size_t size)
+{
+	return &flash[offset];
+}
+
+static int nor_munmap(const struct region_device *rd, void *mapping)
+{
+	return 0;
+}
+
+static ssize_t nor_readat(const struct region_device *rd, void *b,
+			  size_t offset, size_t size)
+{
+	memcpy(b, &flash[offset], size);
+	return size;
+}
+
+static ssize_t nor_writeat(const struct region_device *rd, const void *b,
+			   size_t offset, size_t size)
+{
+	const uint8_t *data = b;
+	size_t i;
+
+	stats.writes++;
+	stats.programmed += size;
+
+	for (i = 0; i < size; i++) {
+		/* Programming can only clear bits. */
+		if ((flash[offset + i] & data[i]) != data[i])
+			stats.bad_programs++;
+		flash[offset + i] &= data[i];
+	}
+
+	return size;
+}
+
+static ssize_t nor_eraseat(const struct region_device *rd, size_t offset,
+			   size_t size)
+{
+	if (offset % SECTOR_SIZE || size % SECTOR_SIZE) {
+		fprintf(stderr, "unaligned erase %zx+%zx\n", offset, size);
+		exit(1);
+	}
+
+	memset(&flash[offset], 0xff, size);
+	stats.erased_sectors += size / SECTOR_SIZE;
+
+	return size;
+}
+
+static const struct region_device_ops nor_ops = {
+	.mmap = nor_mmap,
+	.munmap = nor_munmap,
+	.readat = nor_readat,
+	.writeat = nor_writeat,
+	.eraseat = nor_eraseat,
+};
+
+/* Training data has unused areas, some of which are left erased. */
+static void fill_training_data(uint8_t *data, size_t size)
+{
+	size_t i, j, len;
+
+	for (i = 0; i < size; i += len) {
+		len = MIN(64 + rng() % 1024, size - i);
+
+		if (rng() % 4 == 0) {
+			memset(&data[i], 0xff, len);
+			continue;
+		}
+		for (j = 0; j < len; j++)
+			data[i + j] = rng();
+	}
+}
+
+static void check_latest(const struct region_device *flash_rdev,
+			 const uint8_t *data, size_t size)
+{
+	struct region_file f;
+	struct region_device rdev;
+	const uint8_t *p;
+	size_t i;
+
+	if (region_file_init(&f, flash_rdev) || region_file_data(&f, &rdev)) {
+		fprintf(stderr, "no data after update\n");
+		exit(1);
+	}
+
+	p = rdev_mmap_full(&rdev);
+	if (region_device_sz(&rdev) < size || memcmp(p, data, size)) {
+		fprintf(stderr, "latest data differs\n");
+		exit(1);
+	}
+	for (i = size; i < region_device_sz(&rdev); i++) {
+		if (p[i] != 0xff) {
+			fprintf(stderr, "padding not erased\n");
+			exit(1);
+		}
+	}
+	rdev_munmap(&rdev, (void *)p);
+}
+
+int main(int argc, char **argv)
+{
+	struct region_device flash_rdev;
+	size_t size = argc > 1 ? strtoul(argv[1], NULL, 0) : 12 * KiB;
+	int boots = argc > 2 ? atoi(argv[2]) : 1000;
+	int interval = argc > 3 ? atoi(argv[3]) : 16;
+	uint8_t *data;
+	int boot, changes = 0;
+
+	if (argc > 4)
+		rng_state = strtoull(argv[4], NULL, 0);
+
+	if (size == 0 || size > FLASH_SIZE / 2 || interval < 1) {
+		fprintf(stderr, "usage: %s [data size] [boots] "
+			"[change interval] [seed]\n", argv[0]);
+		return 1;
+	}
+
+	region_device_init(&flash_rdev, &nor_ops, 0, FLASH_SIZE);
+	memset(flash, 0xff, sizeof(flash));
+
+	data = malloc(size);
+	fill_training_data(data, size);
+
+	for (boot = 0; boot < boots; boot++) {
+		struct region_file f;
+
+		/* Retraining moves a few values in the used areas. */
+		if (boot > 0 && boot % interval == 0) {
+			int i = 0;
+
+			while (i < 4) {
+				size_t pos = rng() % size;
+
+				if (data[pos] == 0xff)
+					continue;
+				data[pos] = rng() % 0xff;
+				i++;
+			}
+			changes++;
+		}
+
+		if (region_file_init(&f, &flash_rdev) ||
+		    region_file_update_data(&f, data, size)) {
+			fprintf(stderr, "update failed on boot %d\n", boot);
+			return 1;
+		}
+
+		check_latest(&flash_rdev, data, size);
+	}
+
+	printf("%d boots, %d data changes, %zu bytes of data\n", boots,
+	       changes, size);
+	printf("writes %lu, programmed %lu bytes, erased %lu sectors\n",
+	       stats.writes, stats.programmed, stats.erased_sectors);
+
+	if (stats.bad_programs) {
+		printf("%lu bytes programmed without erasing\n",
+		       stats.bad_programs);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Test for the order in which src/device/device.c places the resources of
+ * a bus.
+ *
+ * compute_resources() and allocate_resources() walk the list that
+ * sort_bus_resources() builds. They used to call largest_resource() for
+ * every resource instead, which is kept below as the reference. Random
+ * buses get resources of all types with few distinct sizes, so there are
+ * many ties, plus fixed and empty resources, disabled devices and
+ * subtractive bridges with further buses behind them. Both have to return
+ * the same resources in the same order for every type the allocator asks
+ * for. The time of both on flat buses goes to stdout.
+ *
+ * usage: resource-order-test [seed]
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "../../src/device/device.c"
+
+#define ROUNDS		2000
+#define MAX_ORDER	4096
+
+struct device_operations default_dev_ops_root;
+const char mainboard_name[] = "resource-order-test";
+struct device dev_root;
+struct device *last_dev = &dev_root;
+
+int do_printk(int msg_level, const char *fmt, ...)
+{
+	return 0;
+}
+
+void die(const char *msg)
+{
+	printf("%s", msg);
+	__builtin_trap();
+}
+
+void post_code(u8 value)
+{
+}
+
+void setup_default_ebda(void)
+{
+}
+
+/* The search compute_resources() and allocate_resources() used before. */
+struct pick_largest_state {
+	struct resource *last;
+	struct device *result_dev;
+	struct resource *result;
+	int seen_last;
+};
+
+static void pick_largest_resource(void *gp, struct device *dev,
+				  struct resource *resource)
+{
+	struct pick_largest_state *state = gp;
+	struct resource *last;
+
+	last = state->last;
+
+	/* Be certain to pick the successor to last. */
+	if (resource == last) {
+		state->seen_last = 1;
+		return;
+	}
+	if (resource->flags & IORESOURCE_FIXED)
+		return;	/* Skip it. */
+	if (last && ((last->align < resource->align) ||
+		     ((last->align == resource->align) &&
+		      (last->size < resource->size)) ||
+		     ((last->align == resource->align) &&
+		      (last->size == resource->size) && (!state->seen_last)))) {
+		return;
+	}
+	if (!state->result ||
+	    (state->result->align < resource->align) ||
+	    ((state->result->align == resource->align) &&
+	     (state->result->size < resource->size))) {
+		state->result_dev = dev;
+		state->result = resource;
+	}
+}
+
+static struct device *largest_resource(struct bus *bus,
+				       struct resource **result_res,
+				       unsigned long type_mask,
+				       unsigned long type)
+{
+	struct pick_largest_state state;
+
+	state.last = *result_res;
+	state.result_dev = NULL;
+	state.result = NULL;
+	state.seen_last = 0;
+
+	search_bus_resources(bus, type_mask, type, pick_largest_resource,
+			     &state);
+
+	*result_res = state.result;
+	return state.result_dev;
+}
+
+static unsigned long long rng_state = 1;
+
+static unsigned long long rng(void)
+{
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return rng_state * 2685821657736338717ULL;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *zalloc(size_t size)
+{
+	void *p = malloc(size);
+
+	memset(p, 0, size);
+	return p;
+}
+
+static void add_resource(struct device *dev, unsigned long flags,
+			 unsigned long index)
+{
+	struct resource *res = zalloc(sizeof(*res));
+	struct resource **tail = &dev->resource_list;
+
+	/* Few distinct alignments and sizes, so many resources tie. */
+	res->align = 4 * (rng() % 4);
+	res->size = (rng() % 8 == 0) ? 0 : (1 + rng() % 3) << res->align;
+	res->flags = flags;
+	res->index = index;
+
+	while (*tail)
+		tail = &(*tail)->next;
+	*tail = res;
+}
+
+static const unsigned long resource_types[] = {
+	IORESOURCE_IO, IORESOURCE_MEM, IORESOURCE_MEM | IORESOURCE_PREFETCH,
+};
+
+static struct bus *random_bus(struct device *parent, unsigned int link_num,
+			      int devices, int depth)
+{
+	struct bus *bus = zalloc(sizeof(*bus));
+	struct device **tail = &bus->children;
+	int i, j, n;
+
+	bus->dev = parent;
+	bus->link_num = link_num;
+
+	for (i = 0; i < devices; i++) {
+		struct device *dev = zalloc(sizeof(*dev));
+
+		dev->bus = bus;
+		dev->enabled = rng() % 16 != 0;
+		n = rng() % 6;
+		for (j = 0; j < n; j++) {
+			unsigned long flags;
+
+			flags = resource_types[rng() % ARRAY_SIZE(
+				resource_types)];
+			if (rng() % 8 == 0)
+				flags |= IORESOURCE_FIXED;
+			add_resource(dev, flags, 0x10 + 4 * j);
+		}
+
+		/*
+		 * A subtractive bridge like an LPC bridge forwards I/O or
+		 * memory, or both, to the bus on its link 0.
+		 */
+		if (depth > 0 && rng() % 4 == 0) {
+			dev->link_list = random_bus(dev, 0, 1 + rng() % 8,
+						    depth - 1);
+			n = 1 + rng() % 3;
+			if (n & 1)
+				add_resource(dev, IORESOURCE_IO |
+					     IORESOURCE_SUBTRACTIVE,
+					     IOINDEX_SUBTRACTIVE(0, 0));
+			if (n & 2)
+				add_resource(dev, IORESOURCE_MEM |
+					     IORESOURCE_SUBTRACTIVE,
+					     IOINDEX_SUBTRACTIVE(1, 0));
+		}
+
+		*tail = dev;
+		tail = &dev->sibling;
+	}
+	return bus;
+}
+
+/* What compute_resources() and allocate_resources() search for. */
+static const struct {
+	unsigned long type_mask;
+	unsigned long type;
+} searches[] = {
+	{ IORESOURCE_TYPE_MASK, IORESOURCE_IO },
+	{ IORESOURCE_TYPE_MASK, IORESOURCE_MEM },
+	{ IORESOURCE_TYPE_MASK | IORESOURCE_PREFETCH, IORESOURCE_MEM },
+	{ IORESOURCE_TYPE_MASK | IORESOURCE_PREFETCH,
+	  IORESOURCE_MEM | IORESOURCE_PREFETCH },
+};
+
+static int check_bus(struct bus *bus, int round)
+{
+	struct resource *resource;
+	struct device *dev;
+	size_t i, s;
+
+	for (s = 0; s < ARRAY_SIZE(searches); s++) {
+		sort_bus_resources(bus, searches[s].type_mask, searches[s].type);
+
+		resource = NULL;
+		i = 0;
+		while ((dev = largest_resource(bus, &resource,
+					       searches[s].type_mask,
+					       searches[s].type))) {
+			if (i >= bus_resources.count ||
+			    bus_resources.entries[i].dev != dev ||
+			    bus_resources.entries[i].res != resource) {
+				printf("round %d, type %lx/%lx: resource %zu "
+				       "differs\n", round,
+				       searches[s].type_mask, searches[s].type,
+				       i);
+				return 1;
+			}
+			i++;
+		}
+		if (i != bus_resources.count) {
+			printf("round %d, type %lx/%lx: %zu sorted resources, "
+			       "%zu found\n", round, searches[s].type_mask,
+			       searches[s].type, bus_resources.count, i);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void time_bus(int devices)
+{
+	const unsigned long mask = IORESOURCE_TYPE_MASK, type = IORESOURCE_MEM;
+	struct bus *bus = random_bus(NULL, 0, devices, 0);
+	struct resource *resource = NULL;
+	double t_sorted, t_search;
+	size_t count;
+	size_t i;
+
+	t_sorted = now();
+	sort_bus_resources(bus, mask, type);
+	for (i = 0; i < bus_resources.count; i++)
+		bus_resources.entries[i].res->base = 0;
+	t_sorted = now() - t_sorted;
+	count = bus_resources.count;
+
+	t_search = now();
+	while (largest_resource(bus, &resource, mask, type))
+		resource->base = 0;
+	t_search = now() - t_search;
+
+	printf("%5d devices %5zu resources: sorted %9.1f us, "
+	       "largest_resource %9.1f us\n", devices, count, t_sorted * 1e6,
+	       t_search * 1e6);
+}
+
+int main(int argc, char **argv)
+{
+	int round, devices;
+
+	if (argc > 1)
+		sscanf(argv[1], "%llu", &rng_state);
+
+	for (round = 0; round < ROUNDS; round++)
+		if (check_bus(random_bus(NULL, 0, 1 + rng() % 32, 3), round))
+			return 1;
+	printf("%d random buses: same order\n", ROUNDS);
+
+	for (devices = 16; devices <= MAX_ORDER; devices *= 4)
+		time_bus(devices);
+
+	return 0;
+}
@@ -0,0 +1,266 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Host benchmark for the rmodule loader in src/lib/rmodule.c.
+ *
+ * Takes an x86 rmodule as written by rmodtool (e.g. the ramstage.rmod in
+ * a coreboot build directory), builds the same module with the version 1
+ * relocation array and loads both versions, copied like the SMM handler and
+ * in place like the ramstage. The loaded images have to be identical.
+ *
+ * The modules are 32-bit, so the loader is built with a 32-bit uintptr_t
+ * and loads into memory mapped below 4GiB.
+ *
+ * usage: rmodule-bench <rmodule> [iterations]
+ */
+
+#include <elf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#define uintptr_t uint32_t
+#include "../../src/lib/rmodule.c"
+#undef uintptr_t
+
+int console_loglevel = BIOS_ERR;
+
+/* Only needed by rmodule_stage_load(), which isn't used here. */
+void *cbmem_add(uint32_t id, uint64_t size) { abort(); }
+ssize_t rdev_readat(const struct region_device *rd, void *b, size_t offset,
+		    size_t size) { abort(); }
+size_t cbfs_load_and_decompress(const struct region_device *rdev,
+				size_t offset, size_t in_size, void *buffer,
+				size_t buffer_size, uint32_t compression)
+{
+	abort();
+}
+const char *prog_name(const struct prog *prog) { abort(); }
+struct region_device *prog_rdev(struct prog *prog) { abort(); }
+void prog_set_area(struct prog *prog, void *start, size_t size) { abort(); }
+void prog_set_entry(struct prog *prog, void *e, void *arg) { abort(); }
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *map_low(size_t size)
+{
+	void *p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+
+	if (p == MAP_FAILED) {
+		perror("mmap");
+		exit(1);
+	}
+	return p;
+}
+
+/* Flatten the allocated sections of the rmodule ELF into the blob that
+ * ends up in CBFS. */
+static uint8_t *read_rmodule(const char *path, size_t *size)
+{
+	const Elf32_Ehdr *ehdr;
+	const Elf32_Shdr *shdr;
+	uint8_t *file, *blob;
+	long file_size;
+	FILE *f;
+	int i;
+
+	f = fopen(path, "rb");
+	if (f == NULL) {
+		perror(path);
+		exit(1);
+	}
+	fseek(f, 0, SEEK_END);
+	file_size = ftell(f);
+	rewind(f);
+	file = malloc(file_size);
+	if (fread(file, file_size, 1, f) != 1) {
+		perror(path);
+		exit(1);
+	}
+	fclose(f);
+
+	ehdr = (const Elf32_Ehdr *)file;
+	if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) ||
+	    ehdr->e_ident[EI_CLASS] != ELFCLASS32 ||
+	    ehdr->e_machine != EM_386) {
+		fprintf(stderr, "%s: not a 32-bit x86 ELF file\n", path);
+		exit(1);
+	}
+	shdr = (const Elf32_Shdr *)(file + ehdr->e_shoff);
+
+	*size = 0;
+	for (i = 0; i < ehdr->e_shnum; i++) {
+		if (shdr[i].sh_type == SHT_PROGBITS &&
+		    (shdr[i].sh_flags & SHF_ALLOC))
+			*size = MAX(*size, shdr[i].sh_addr + shdr[i].sh_size);
+	}
+
+	blob = calloc(1, *size);
+	for (i = 0; i < ehdr->e_shnum; i++) {
+		if (shdr[i].sh_type == SHT_PROGBITS &&
+		    (shdr[i].sh_flags & SHF_ALLOC))
+			memcpy(blob + shdr[i].sh_addr,
+			       file + shdr[i].sh_offset, shdr[i].sh_size);
+	}
+
+	free(file);
+	return blob;
+}
+
+/* Rewrite a version 2 module with the plain array of relocations. */
+static uint8_t *to_version_1(const uint8_t *blob, size_t *size)
+{
+	const struct rmodule_header *hdr = (const void *)blob;
+	const uint8_t *p = blob + hdr->relocations_begin_offset;
+	const uint8_t *end = blob + hdr->relocations_end_offset;
+	struct rmodule_header *out_hdr;
+	uint32_t *relocs, addr = 0;
+	size_t n = 0, max = 1024;
+	uint8_t *out;
+
+	relocs = malloc(max * sizeof(*relocs));
+	while (p < end) {
+		size_t distance, count;
+
+		if (rmodule_get_reloc_run(&p, end, &distance, &count)) {
+			fprintf(stderr, "malformed relocations\n");
+			exit(1);
+		}
+		for (addr += distance; count > 0; count--) {
+			if (n == max)
+				relocs = realloc(relocs,
+						 (max *= 2) * sizeof(*relocs));
+			relocs[n++] = addr;
+			addr += sizeof(uint32_t);
+		}
+	}
+
+	*size = hdr->relocations_begin_offset + n * sizeof(*relocs);
+	out = malloc(*size);
+	memcpy(out, blob, hdr->relocations_begin_offset);
+	memcpy(out + hdr->relocations_begin_offset, relocs,
+	       n * sizeof(*relocs));
+	out_hdr = (void *)out;
+	out_hdr->version = RMODULE_VERSION_1;
+	out_hdr->relocations_end_offset = *size;
+
+	free(relocs);
+	return out;
+}
+
+/*
+ * Load the module to base iterations times and return the average time. With
+ * in_place the blob is placed so that the payload already is at the load
+ * address, the way rmodule_stage_load() does it.
+ */
+static double load(const uint8_t *blob, size_t blob_size, uint8_t *base,
+		   int in_place, int iterations)
+{
+	const struct rmodule_header *hdr = (const void *)blob;
+	uint8_t *rmod_loc;
+	struct rmodule module;
+	double total = 0;
+	int i;
+
+	rmod_loc = in_place ? base - hdr->payload_begin_offset :
+		malloc(blob_size);
+
+	for (i = 0; i < iterations; i++) {
+		double start;
+
+		memcpy(rmod_loc, blob, blob_size);
+		start = now();
+		if (rmodule_parse(rmod_loc, &module) ||
+		    rmodule_load(base, &module)) {
+			fprintf(stderr, "loading the module failed\n");
+			exit(1);
+		}
+		total += now() - start;
+	}
+
+	if (!in_place)
+		free(rmod_loc);
+
+	return total / iterations;
+}
+
+int main(int argc, char **argv)
+{
+	const struct rmodule_header *hdr;
+	uint8_t *v2, *v1, *base, *image;
+	size_t v2_size, v1_size, memsize, payload_size, bss;
+	int iterations, in_place;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <rmodule> [iterations]\n", argv[0]);
+		return 1;
+	}
+	iterations = argc > 2 ? atoi(argv[2]) : 1000;
+
+	v2 = read_rmodule(argv[1], &v2_size);
+	hdr = (const void *)v2;
+	if (hdr->magic != RMODULE_MAGIC || hdr->version != RMODULE_VERSION_2) {
+		fprintf(stderr, "%s: not a version 2 rmodule\n", argv[1]);
+		return 1;
+	}
+	v1 = to_version_1(v2, &v1_size);
+
+	printf("payload %u bytes, memory %u bytes, relocations %zu bytes "
+	       "(version 1: %zu bytes)\n",
+	       hdr->payload_end_offset - hdr->payload_begin_offset,
+	       hdr->module_program_size, v2_size - hdr->relocations_begin_offset,
+	       v1_size - hdr->relocations_begin_offset);
+
+	/* Both versions are loaded to the same address, leaving room for the
+	 * header in front of it for in place loads. */
+	memsize = hdr->module_program_size;
+	payload_size = hdr->payload_end_offset - hdr->payload_begin_offset;
+	bss = hdr->bss_begin - hdr->module_link_start_address;
+	base = (uint8_t *)map_low(4096 + MAX(v1_size, memsize)) + 4096;
+	image = malloc(memsize);
+
+	for (in_place = 0; in_place <= 1; in_place++) {
+		double t1, t2;
+
+		t1 = load(v1, v1_size, base, in_place, iterations);
+		memcpy(image, base, memsize);
+		t2 = load(v2, v2_size, base, in_place, iterations);
+		/* Only the payload and the bss are defined, the leftovers of
+		 * the relocations in between differ. */
+		if (bss > payload_size) {
+			memset(image + payload_size, 0, bss - payload_size);
+			memset(base + payload_size, 0, bss - payload_size);
+		}
+
+		printf("%-8s version 1 %8.1f us, version 2 %8.1f us\n",
+		       in_place ? "in place" : "copy", t1 * 1e6, t2 * 1e6);
+
+		if (memcmp(image, base, memsize)) {
+			printf("loaded images differ\n");
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,11 @@
+/* Host builds of coreboot code, see ../../Makefile. */
+#pragma once
+#include <stdint.h>
+
+/* Defined by each test. */
+void outb(u8 val, u16 port);
+void outw(u16 val, u16 port);
+void outl(u32 val, u16 port);
+u8 inb(u16 port);
+u16 inw(u16 port);
+u32 inl(u16 port);
@@ -0,0 +1,6 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+#include_next <assert.h>
+#include <stdlib.h>
+
+#define BUG() abort()
@@ -0,0 +1,6 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+/* Nothing runs the boot state callbacks, but keep them referenced. */
+#define BOOT_STATE_INIT_ENTRY(state_, when_, func_, arg_) \
+	static void (*const func_##_##state_##_##when_)(void *) \
+		__attribute__((unused)) = func_
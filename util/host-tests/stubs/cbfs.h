@@ -0,0 +1,13 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+#include <stddef.h>
+#include <sys/types.h>
+#include <commonlib/cbfs_serialized.h>
+
+struct region_device;
+
+ssize_t rdev_readat(const struct region_device *rd, void *b, size_t offset,
+		    size_t size);
+size_t cbfs_load_and_decompress(const struct region_device *rdev,
+				size_t offset, size_t in_size, void *buffer,
+				size_t buffer_size, uint32_t compression);
@@ -0,0 +1,14 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <commonlib/cbmem_id.h>
+
+#define DYN_CBMEM_ALIGN_SIZE (4096 * 4)
+
+void *cbmem_add(uint32_t id, uint64_t size);
+void *cbmem_find(uint32_t id);
+
+#define RAMSTAGE_CBMEM_INIT_HOOK(init_fn_)				\
+	static void (*const init_fn_ ## _ptr_)(int) __attribute__((unused)) = \
+		init_fn_;
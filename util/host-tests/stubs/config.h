@@ -0,0 +1,3 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+#define ENV_RAMSTAGE 1
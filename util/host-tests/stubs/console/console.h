@@ -0,0 +1,24 @@
+/* Host builds of coreboot code, see ../../Makefile. */
+#pragma once
+#include <stdio.h>
+
+#define BIOS_EMERG	0
+#define BIOS_ALERT	1
+#define BIOS_CRIT	2
+#define BIOS_ERR	3
+#define BIOS_WARNING	4
+#define BIOS_NOTICE	5
+#define BIOS_INFO	6
+#define BIOS_DEBUG	7
+#define BIOS_SPEW	8
+#define BIOS_NEVER	9
+
+/* Defined by each test. */
+extern int console_loglevel;
+
+#define printk(level, ...) do {					\
+		if ((level) <= console_loglevel)			\
+			fprintf(stderr, __VA_ARGS__);			\
+	} while (0)
+
+#define post_code(x) do { } while (0)
@@ -0,0 +1,3 @@
+/* Host builds of coreboot code, see ../../Makefile. */
+#pragma once
+int cpu_phys_address_size(void);
@@ -0,0 +1,4 @@
+/* Host builds of coreboot code, see ../../../Makefile. */
+#pragma once
+static inline void disable_cache(void) { }
+static inline void enable_cache(void) { }
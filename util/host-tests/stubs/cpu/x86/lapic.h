@@ -0,0 +1 @@
+/* Host builds of coreboot code, see ../../../Makefile. */
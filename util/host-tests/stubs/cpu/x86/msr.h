@@ -0,0 +1,11 @@
+/* Host builds of coreboot code, see ../../../Makefile. */
+#pragma once
+#include <stdint.h>
+
+typedef struct msr_struct {
+	uint32_t lo;
+	uint32_t hi;
+} msr_t;
+
+msr_t rdmsr(unsigned int index);
+void wrmsr(unsigned int index, msr_t msr);
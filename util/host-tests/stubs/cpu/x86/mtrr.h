@@ -0,0 +1,3 @@
+/* Host builds of coreboot code, see ../../../Makefile. */
+#pragma once
+#include "../../../../../src/include/cpu/x86/mtrr.h"
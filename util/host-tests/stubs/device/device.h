@@ -0,0 +1,18 @@
+/* Host builds of coreboot code, see ../../Makefile. */
+#pragma once
+#include <device/resource.h>
+
+enum device_path_type {
+	DEVICE_PATH_NONE = 0,
+	DEVICE_PATH_ROOT,
+	DEVICE_PATH_PCI,
+};
+
+struct device_path {
+	enum device_path_type type;
+};
+
+struct device {
+	struct device_path path;
+	unsigned int class;
+};
@@ -0,0 +1,3 @@
+/* Host builds of coreboot code, see ../../Makefile. */
+#pragma once
+#define PCI_CLASS_DISPLAY_VGA		0x0300
@@ -0,0 +1,22 @@
+/* Host builds of coreboot code, see ../../Makefile. */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#define IORESOURCE_MEM		0x00000200
+#define IORESOURCE_PREFETCH	0x00001000
+#define IORESOURCE_CACHEABLE	0x00004000
+
+typedef u64 resource_t;
+
+struct device;
+struct resource {
+	resource_t base;
+	resource_t size;
+	unsigned long flags;
+};
+
+typedef void (*resource_search_t)(void *gp, struct device *dev,
+				  struct resource *res);
+void search_global_resources(unsigned long type_mask, unsigned long type,
+			     resource_search_t search, void *gp);
@@ -0,0 +1,9 @@
+/* Host builds of coreboot code, see ../../Makefile. */
+#pragma once
+#define CONFIG_ARCH_X86 1
+#define CONFIG_ARCH_RAMSTAGE_X86_32 1
+#define CONFIG_PCI 1
+#define CONFIG_MMCONF_BASE_ADDRESS 0xe0000000
+#define CONFIG_MMCONF_BUS_NUMBER 256
+#define CONFIG_STACK_SIZE 0x1000
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL 7
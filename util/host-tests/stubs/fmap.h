@@ -0,0 +1,5 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+#include <commonlib/region.h>
+
+int fmap_locate_area_as_rdev(const char *name, struct region_device *area);
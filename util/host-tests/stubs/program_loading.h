@@ -0,0 +1,19 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+enum prog_segment_type {
+	SEG_FINAL = 1 << 0,
+};
+
+struct prog;
+struct region_device;
+
+static inline void prog_segment_loaded(uintptr_t start, size_t size,
+				       int flags) { }
+
+const char *prog_name(const struct prog *prog);
+struct region_device *prog_rdev(struct prog *prog);
+void prog_set_area(struct prog *prog, void *start, size_t size);
+void prog_set_entry(struct prog *prog, void *e, void *arg);
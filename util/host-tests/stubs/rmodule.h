@@ -0,0 +1,2 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#include "../../../src/include/rmodule.h"
@@ -0,0 +1,13 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+#include_next <stdint.h>
+
+/* coreboot's stdint.h also has the short names, with 64-bit long long. */
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef unsigned long long u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef signed long long s64;
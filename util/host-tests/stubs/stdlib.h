@@ -0,0 +1,5 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+#include_next <stdlib.h>
+#include <stdbool.h>
+#include <commonlib/helpers.h>
@@ -0,0 +1,4 @@
+/* Host builds of coreboot code, see ../Makefile. */
+#pragma once
+
+#define timestamp_add_now(id) do { } while (0)
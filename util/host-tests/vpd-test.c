@@ -0,0 +1,259 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Test for the key index of the VPD copy in
+ * src/vendorcode/google/chromeos/cros_vpd.c.
+ *
+ * Builds VPD blobs with the keys of a typical Chromebook and with random
+ * keys, including duplicates and values with multi-byte lengths. Every key
+ * and some missing ones are looked up with the index and with the linear
+ * search, which have to agree. Lookup times of both go to stdout.
+ *
+ * usage: vpd-test [seed]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../src/vendorcode/google/chromeos/cros_vpd.c"
+
+int console_loglevel = BIOS_ERR;
+
+#define MAX_KEYS	1024
+#define ROUNDS		100
+
+static struct vpd_cbmem *vpd_copy;
+static void *vpd_index_copy;
+
+void *cbmem_add(uint32_t id, uint64_t size)
+{
+	if (id != CBMEM_ID_VPD_INDEX)
+		abort();
+	free(vpd_index_copy);
+	vpd_index_copy = malloc(size);
+	return vpd_index_copy;
+}
+
+void *cbmem_find(uint32_t id)
+{
+	if (id == CBMEM_ID_VPD)
+		return vpd_copy;
+	if (id == CBMEM_ID_VPD_INDEX)
+		return vpd_index_copy;
+	return NULL;
+}
+
+/* Only needed by cbmem_add_cros_vpd(), which isn't used here. */
+int fmap_locate_area_as_rdev(const char *name, struct region_device *area)
+{
+	abort();
+}
+
+ssize_t rdev_readat(const struct region_device *rd, void *b, size_t offset,
+		    size_t size)
+{
+	abort();
+}
+
+int rdev_chain(struct region_device *child, const struct region_device *parent,
+	       size_t offset, size_t size)
+{
+	abort();
+}
+
+static unsigned long long rng_state = 1;
+
+static unsigned long long rng(void)
+{
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return rng_state * 2685821657736338717ULL;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char keys[MAX_KEYS][40];
+static int num_keys;
+static uint8_t blob[256 * 1024];
+static size_t blob_size;
+
+static void put_len(size_t len)
+{
+	int shift = 0;
+
+	while (len >> (shift + 7))
+		shift += 7;
+	for (; shift > 0; shift -= 7)
+		blob[blob_size++] = 0x80 | ((len >> shift) & 0x7f);
+	blob[blob_size++] = len & 0x7f;
+}
+
+static void add_pair(const char *key, size_t value_len)
+{
+	size_t i;
+
+	blob[blob_size++] = VPD_TYPE_STRING;
+	put_len(strlen(key));
+	memcpy(&blob[blob_size], key, strlen(key));
+	blob_size += strlen(key);
+	put_len(value_len);
+	for (i = 0; i < value_len; i++)
+		blob[blob_size++] = 'A' + rng() % 26;
+
+	if (num_keys < MAX_KEYS)
+		strcpy(keys[num_keys++], key);
+}
+
+static void start_blob(void)
+{
+	free(vpd_index_copy);
+	vpd_index_copy = NULL;
+	num_keys = 0;
+	blob_size = 0;
+}
+
+static void finish_blob(void)
+{
+	blob[blob_size++] = VPD_TYPE_TERMINATOR;
+
+	free(vpd_copy);
+	vpd_copy = malloc(sizeof(*vpd_copy) + blob_size);
+	vpd_copy->magic = CROSVPD_CBMEM_MAGIC;
+	vpd_copy->version = CROSVPD_CBMEM_VERSION;
+	vpd_copy->ro_size = blob_size;
+	vpd_copy->rw_size = 0;
+	memcpy(vpd_copy->blob, blob, blob_size);
+
+	cbmem_add_cros_vpd_index(vpd_copy);
+}
+
+static int count_callback(const char *key, int key_len, const void *value,
+			  int value_len, void *arg)
+{
+	(*(int *)arg)++;
+	return 0;
+}
+
+/* Look every key up with and without the index. */
+static int check_blob(const char *name)
+{
+	const void *with[MAX_KEYS + 16], *without[MAX_KEYS + 16];
+	int size_with[MAX_KEYS + 16], size_without[MAX_KEYS + 16];
+	char missing[16][40];
+	const int num_missing = 16;
+	void *index = vpd_index_copy;
+	double t_with, t_without;
+	int i, r, n, count = 0;
+
+	for (i = 0; i < num_missing; i++)
+		snprintf(missing[i], sizeof(missing[i]), "%s_missing%d",
+			 i < num_keys ? keys[i] : "key", i);
+	n = num_keys + num_missing;
+
+#define KEY(i) ((i) < num_keys ? keys[i] : missing[(i) - num_keys])
+	t_with = now();
+	for (r = 0; r < ROUNDS; r++)
+		for (i = 0; i < n; i++)
+			with[i] = cros_vpd_find(KEY(i), &size_with[i]);
+	t_with = now() - t_with;
+
+	vpd_index_copy = NULL;
+	t_without = now();
+	for (r = 0; r < ROUNDS; r++)
+		for (i = 0; i < n; i++)
+			without[i] = cros_vpd_find(KEY(i), &size_without[i]);
+	t_without = now() - t_without;
+	vpd_index_copy = index;
+
+	for (i = 0; i < n; i++) {
+		if (with[i] != without[i] ||
+		    (with[i] && size_with[i] != size_without[i])) {
+			printf("%s: lookup of '%s' differs\n", name, KEY(i));
+			return 1;
+		}
+		if ((with[i] == NULL) != (i >= num_keys)) {
+			printf("%s: lookup of '%s' is wrong\n", name, KEY(i));
+			return 1;
+		}
+	}
+#undef KEY
+
+	cros_vpd_foreach(count_callback, &count);
+	if (count != num_keys) {
+		printf("%s: %d entries iterated, %d stored\n", name, count,
+		       num_keys);
+		return 1;
+	}
+
+	printf("%-10s %4d keys %6zu bytes: index %7.2f us, linear %7.2f us "
+	       "per lookup\n", name, num_keys, blob_size, t_with * 1e6 / (n * ROUNDS),
+	       t_without * 1e6 / (n * ROUNDS));
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	static const char * const chromebook[] = {
+		"serial_number", "region", "initial_locale", "initial_timezone",
+		"keyboard_layout", "model_name", "customization_id",
+		"ethernet_mac0", "ethernet_mac1", "wifi_mac0",
+		"wifi_base64_calibration0", "wifi_base64_calibration1",
+		"wifi_sar", "gbind_attribute", "ubind_attribute",
+		"stable_device_secret_DO_NOT_SHARE", "mlb_serial_number",
+	};
+	int i, round, ret = 0;
+
+	if (argc > 1)
+		rng_state = strtoull(argv[1], NULL, 0);
+
+	start_blob();
+	for (i = 0; i < ARRAY_SIZE(chromebook); i++)
+		add_pair(chromebook[i], strstr(chromebook[i], "calibration") ?
+			 1500 + rng() % 500 : 1 + rng() % 64);
+	finish_blob();
+	ret |= check_blob("chromebook");
+
+	for (round = 0; round < 8 && !ret; round++) {
+		const int n = 1 << (round + 2);
+		char name[16];
+
+		start_blob();
+		for (i = 0; i < n; i++) {
+			char key[40];
+
+			/* Some duplicates and prefixes of other keys. */
+			if (i > 0 && rng() % 8 == 0)
+				strcpy(key, keys[rng() % num_keys]);
+			else
+				snprintf(key, sizeof(key), "key%llu",
+					 rng() % (4 * n));
+			add_pair(key, rng() % 300);
+		}
+		finish_blob();
+		snprintf(name, sizeof(name), "random%d", n);
+		ret |= check_blob(name);
+	}
+
+	return ret;
+}
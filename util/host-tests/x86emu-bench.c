@@ -0,0 +1,366 @@
+/*
+ * This file is part of the coreboot project.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 2 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+/*
+ * Host benchmark for the x86emu interpreter in src/device/oprom/x86emu.
+ *
+ * Runs the init entry point of a PCI option ROM such as a VGA BIOS against
+ * emulated I/O: PCI config space shows the device described by the ROM's
+ * PCI data structure with unassigned BARs, every other port reads back what
+ * was last written to it and the VGA input status register toggles its
+ * retrace bits. The memory functions look every access up in a table of
+ * address translations like YABEL's do.
+ *
+ * The ROM runs once with and once without the page lookup that lets x86emu
+ * fetch instructions and run REP MOVS/STOS straight from memory. Both runs
+ * stop after the same number of instructions and have to end up in the same
+ * state.
+ *
+ * usage: x86emu-bench <option rom> [max instructions] [devfn]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <commonlib/helpers.h>
+#include <x86emu/x86emu.h>
+#include "../../src/device/oprom/x86emu/ops.h"
+
+int console_loglevel = BIOS_ERR;
+
+#define MEM_SIZE	(1024 * 1024)
+#define ROM_BASE	0xc0000
+#define RETURN_ADDR	0x600		/* filled with HLT */
+#define STACK_SEG	0x1000
+
+static u8 *mem;
+static u8 ports[0x10000];
+static u32 pci_addr;
+static u16 vendor_id, device_id;
+static u32 class_rev;
+static u16 devfn;
+
+/* Address translations of a typical graphics device, none below 1MiB. */
+static const struct {
+	u32 base;
+	u32 size;
+} translations[] = {
+	{ 0xe0000000, 0x10000000 },
+	{ 0xf0000000, 0x01000000 },
+	{ 0xf1000000, 0x00400000 },
+	{ 0xf1400000, 0x00020000 },
+	{ 0xf1420000, 0x00001000 },
+	{ 0xf1421000, 0x00000100 },
+	{ 0xf1500000, 0x00010000 },
+	{ 0xfed00000, 0x00004000 },
+};
+
+static int translated(u32 addr)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(translations); i++) {
+		if (addr >= translations[i].base &&
+		    addr <= translations[i].base + translations[i].size)
+			return 1;
+	}
+	return 0;
+}
+
+static u8 bench_rdb(u32 addr)
+{
+	if (translated(addr) || addr >= MEM_SIZE)
+		return 0xff;
+	return mem[addr];
+}
+
+static u16 bench_rdw(u32 addr)
+{
+	if (translated(addr) || addr > MEM_SIZE - 2)
+		return 0xffff;
+	return mem[addr] | mem[addr + 1] << 8;
+}
+
+static u32 bench_rdl(u32 addr)
+{
+	if (translated(addr) || addr > MEM_SIZE - 4)
+		return 0xffffffff;
+	return mem[addr] | mem[addr + 1] << 8 | mem[addr + 2] << 16 |
+		(u32)mem[addr + 3] << 24;
+}
+
+static void bench_wrb(u32 addr, u8 val)
+{
+	if (translated(addr) || addr >= MEM_SIZE)
+		return;
+	mem[addr] = val;
+}
+
+static void bench_wrw(u32 addr, u16 val)
+{
+	bench_wrb(addr, val);
+	bench_wrb(addr + 1, val >> 8);
+}
+
+static void bench_wrl(u32 addr, u32 val)
+{
+	bench_wrw(addr, val);
+	bench_wrw(addr + 2, val >> 16);
+}
+
+static u8 *bench_page(u32 addr)
+{
+	addr &= ~(X86EMU_PAGE_SIZE - 1);
+	if (addr > MEM_SIZE - X86EMU_PAGE_SIZE)
+		return NULL;
+	return mem + addr;
+}
+
+static X86EMU_memFuncs mem_funcs = {
+	bench_rdb, bench_rdw, bench_rdl,
+	bench_wrb, bench_wrw, bench_wrl,
+	bench_page
+};
+
+static u32 pci_read(void)
+{
+	unsigned int reg = pci_addr & 0xfc;
+
+	if (!(pci_addr & 0x80000000) || ((pci_addr >> 8) & 0xffff) != devfn)
+		return 0xffffffff;
+	switch (reg) {
+	case 0x00:
+		return vendor_id | device_id << 16;
+	case 0x08:
+		return class_rev;
+	case 0x0c:
+		return 0x00800000;
+	default:
+		return 0;
+	}
+}
+
+static u32 port_read(u16 port, int size)
+{
+	u32 val = 0;
+	int i;
+
+	if ((port & ~3) == 0xcfc)
+		return pci_read() >> (8 * (port & 3));
+	if (port == 0xcf8 && size == 4)
+		return pci_addr;
+	/* Input status 1: toggle display enable and vertical retrace. */
+	if (port == 0x3da || port == 0x3ba)
+		ports[port] ^= 0x09;
+	for (i = size - 1; i >= 0; i--)
+		val = val << 8 | ports[(u16)(port + i)];
+	return val;
+}
+
+static void port_write(u16 port, u32 val, int size)
+{
+	int i;
+
+	if (port == 0xcf8 && size == 4) {
+		pci_addr = val;
+		return;
+	}
+	for (i = 0; i < size; i++, val >>= 8)
+		ports[(u16)(port + i)] = val;
+}
+
+u8 inb(u16 port) { return port_read(port, 1); }
+u16 inw(u16 port) { return port_read(port, 2); }
+u32 inl(u16 port) { return port_read(port, 4); }
+void outb(u8 val, u16 port) { port_write(port, val, 1); }
+void outw(u16 val, u16 port) { port_write(port, val, 2); }
+void outl(u32 val, u16 port) { port_write(port, val, 4); }
+
+/* No system BIOS services: PCI BIOS and int 15h calls fail. */
+static void int_unsupported(int num)
+{
+	M.x86.R_AH = num == 0x1a ? 0x81 : 0x86;
+	M.x86.R_FLG |= F_CF;
+}
+
+static void (*run_optab[256])(u8 op1);
+static unsigned long instructions, max_instructions;
+
+static void count_op(u8 op1)
+{
+	if (++instructions >= max_instructions)
+		X86EMU_halt_sys();
+	(*run_optab[op1])(op1);
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static u8 *read_rom(const char *path, size_t *size)
+{
+	const u8 *pcir;
+	long file_size;
+	u8 *rom;
+	FILE *f;
+
+	f = fopen(path, "rb");
+	if (f == NULL) {
+		perror(path);
+		exit(1);
+	}
+	fseek(f, 0, SEEK_END);
+	file_size = ftell(f);
+	rewind(f);
+	if (file_size < 0x20 || file_size > MEM_SIZE - ROM_BASE) {
+		fprintf(stderr, "%s: bad size\n", path);
+		exit(1);
+	}
+	rom = malloc(file_size);
+	if (fread(rom, file_size, 1, f) != 1) {
+		perror(path);
+		exit(1);
+	}
+	fclose(f);
+
+	if (rom[0] != 0x55 || rom[1] != 0xaa) {
+		fprintf(stderr, "%s: not an option ROM\n", path);
+		exit(1);
+	}
+	*size = MIN((size_t)rom[2] * 512, (size_t)file_size);
+
+	pcir = rom + (rom[0x18] | rom[0x19] << 8);
+	if (pcir + 0x10 <= rom + file_size && !memcmp(pcir, "PCIR", 4)) {
+		vendor_id = pcir[4] | pcir[5] << 8;
+		device_id = pcir[6] | pcir[7] << 8;
+		class_rev = pcir[0xd] << 8 | pcir[0xe] << 16 |
+			(u32)pcir[0xf] << 24;
+	}
+	return rom;
+}
+
+/* Set up memory, I/O and registers for the ROM's init entry point. */
+static void setup(const u8 *rom, size_t rom_size)
+{
+	X86EMU_intrFuncs intr_funcs[256] = { NULL };
+	int i;
+
+	memset(&M, 0, sizeof(M));
+	memset(mem, 0xf4, MEM_SIZE);
+	memset(mem, 0, 0x500);
+	/* All interrupt vectors point to an IRET in the system BIOS. */
+	for (i = 0; i < 256; i++) {
+		mem[i * 4 + 0] = 0x53;
+		mem[i * 4 + 1] = 0xff;
+		mem[i * 4 + 2] = 0x00;
+		mem[i * 4 + 3] = 0xf0;
+	}
+	mem[0xfff53] = 0xcf;
+	memcpy(mem + ROM_BASE, rom, rom_size);
+
+	memset(ports, 0xff, sizeof(ports));
+	pci_addr = 0;
+
+	intr_funcs[0x15] = int_unsupported;
+	intr_funcs[0x1a] = int_unsupported;
+	X86EMU_setupIntrFuncs(intr_funcs);
+	X86EMU_setMemBase(mem, MEM_SIZE);
+
+	M.x86.R_AX = devfn;
+	M.x86.R_DX = 0x80;
+	M.x86.R_SS = STACK_SEG;
+	M.x86.R_SP = 0xfffe;
+	M.x86.R_DS = 0x0040;
+	M.x86.R_CS = ROM_BASE >> 4;
+	M.x86.R_IP = 3;
+	/* The far return of the init entry point ends up at a HLT. */
+	M.x86.R_SP -= 4;
+	mem[(STACK_SEG << 4) + M.x86.R_SP + 0] = RETURN_ADDR & 0xff;
+	mem[(STACK_SEG << 4) + M.x86.R_SP + 1] = RETURN_ADDR >> 8;
+	mem[(STACK_SEG << 4) + M.x86.R_SP + 2] = 0;
+	mem[(STACK_SEG << 4) + M.x86.R_SP + 3] = 0;
+}
+
+static double run(const u8 *rom, size_t rom_size, int page_lookup)
+{
+	double start;
+
+	setup(rom, rom_size);
+	mem_funcs.page = page_lookup ? bench_page : NULL;
+	X86EMU_setupMemFuncs(&mem_funcs);
+
+	instructions = 0;
+	start = now();
+	X86EMU_exec();
+	return now() - start;
+}
+
+int main(int argc, char **argv)
+{
+	X86EMU_regs regs;
+	size_t rom_size;
+	double t_slow, t_fast;
+	u8 *rom, *image;
+	unsigned long slow_instructions;
+	int i;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <option rom> [max instructions] "
+			"[devfn]\n", argv[0]);
+		return 1;
+	}
+	max_instructions = argc > 2 ? strtoul(argv[2], NULL, 0) : 100000000;
+	devfn = argc > 3 ? strtoul(argv[3], NULL, 0) : 0x10;
+
+	rom = read_rom(argv[1], &rom_size);
+	printf("ROM %u bytes, device %04x:%04x class %06x at 00:%02x.%x\n",
+	       (unsigned int)rom_size, vendor_id, device_id, class_rev >> 8,
+	       devfn >> 3, devfn & 7);
+
+	mem = malloc(MEM_SIZE);
+	image = malloc(MEM_SIZE);
+
+	memcpy(run_optab, x86emu_optab, sizeof(run_optab));
+	for (i = 0; i < 256; i++)
+		x86emu_optab[i] = count_op;
+
+	t_slow = run(rom, rom_size, 0);
+	slow_instructions = instructions;
+	regs = M.x86;
+	memcpy(image, mem, MEM_SIZE);
+
+	t_fast = run(rom, rom_size, 1);
+
+	printf("%lu instructions%s, ended at %04x:%04x\n", instructions,
+	       instructions >= max_instructions ? " (limit)" : "",
+	       M.x86.R_CS, M.x86.R_IP);
+	printf("memory functions only %8.2f s %8.2f M instructions/s\n",
+	       t_slow, slow_instructions / t_slow / 1e6);
+	printf("page lookup           %8.2f s %8.2f M instructions/s\n",
+	       t_fast, instructions / t_fast / 1e6);
+
+	if (slow_instructions != instructions ||
+	    memcmp(&regs, &M.x86, sizeof(regs)) ||
+	    memcmp(image, mem, MEM_SIZE)) {
+		printf("final states differ\n");
+		return 1;
+	}
+
+	return 0;
+}
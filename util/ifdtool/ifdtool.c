@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <getopt.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -31,6 +32,7 @@ static int ifd_version;
 static int max_regions = 0;
 static int selected_chip = 0;
 static int platform = -1;
+static char *output_fname = NULL;
 
 static const struct region_name region_names[MAX_REGIONS] = {
 	{ "Flash Descriptor", "fd" },
@@ -690,32 +692,59 @@ static void write_regions(char *image, int size)
 	}
 }
 
+/*
+ * Write the image to the output file, or <filename>.new if none was given.
+ * It is written to a temporary file first and renamed, so the output file
+ * may be the input file itself.
+ */
 static void write_image(char *filename, char *image, int size)
 {
 	char new_filename[FILENAME_MAX]; // allow long file names
+	char tmp_filename[FILENAME_MAX + 4];
 	int new_fd;
 
-	// - 5: leave room for ".new\0"
-	strncpy(new_filename, filename, FILENAME_MAX - 5);
-	strncat(new_filename, ".new", FILENAME_MAX - strlen(filename));
+	if (output_fname)
+		snprintf(new_filename, sizeof(new_filename), "%s",
+			 output_fname);
+	else
+		snprintf(new_filename, sizeof(new_filename), "%s.new",
+			 filename);
+	snprintf(tmp_filename, sizeof(tmp_filename), "%s.tmp", new_filename);
 
 	printf("Writing new image to %s\n", new_filename);
 
 	// Now write out new image
-	new_fd = open(new_filename,
+	new_fd = open(tmp_filename,
 			 O_WRONLY | O_CREAT | O_TRUNC | O_BINARY,
 			 S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
 	if (new_fd < 0) {
 		perror("Error while trying to open file");
 		exit(EXIT_FAILURE);
 	}
-	if (write(new_fd, image, size) != size)
+	if (write(new_fd, image, size) != size) {
 		perror("Error while writing");
+		close(new_fd);
+		unlink(tmp_filename);
+		exit(EXIT_FAILURE);
+	}
 	close(new_fd);
+
+#ifdef _WIN32
+	/* rename() doesn't replace existing files on Windows. */
+	if (unlink(new_filename) && errno != ENOENT) {
+		perror("Error while removing old image");
+		unlink(tmp_filename);
+		exit(EXIT_FAILURE);
+	}
+#endif
+	if (rename(tmp_filename, new_filename)) {
+		perror("Error while renaming");
+		unlink(tmp_filename);
+		exit(EXIT_FAILURE);
+	}
 }
 
-static void set_spi_frequency(char *filename, char *image, int size,
-			      enum spi_frequency freq)
+static void set_spi_frequency(char *image, int size, enum spi_frequency freq)
 {
 	fdbar_t *fdb = find_fd(image, size);
 	fcba_t *fcba = (fcba_t *) (image + (((fdb->flmap0) & 0xff) << 4));
@@ -728,11 +757,9 @@ static void set_spi_frequency(char *filename, char *image, int size,
 	fcba->flcomp |= freq << 24;
 	/* Fast Read Clock Frequency */
 	fcba->flcomp |= freq << 21;
-
-	write_image(filename, image, size);
 }
 
-static void set_em100_mode(char *filename, char *image, int size)
+static void set_em100_mode(char *image, int size)
 {
 	fdbar_t *fdb = find_fd(image, size);
 	fcba_t *fcba = (fcba_t *) (image + (((fdb->flmap0) & 0xff) << 4));
@@ -751,11 +778,10 @@ static void set_em100_mode(char *filename, char *image, int size)
 	}
 
 	fcba->flcomp &= ~(1 << 30);
-	set_spi_frequency(filename, image, size, freq);
+	set_spi_frequency(image, size, freq);
 }
 
-static void set_chipdensity(char *filename, char *image, int size,
-                            unsigned int density)
+static void set_chipdensity(char *image, int size, unsigned int density)
 {
 	fdbar_t *fdb = find_fd(image, size);
 	fcba_t *fcba = (fcba_t *) (image + (((fdb->flmap0) & 0xff) << 4));
@@ -803,11 +829,9 @@ static void set_chipdensity(char *filename, char *image, int size,
 		fcba->flcomp |= (density); /* first chip */
 	if (selected_chip == 2 || selected_chip == 0)
 		fcba->flcomp |= (density << 3); /* second chip */
-
-	write_image(filename, image, size);
 }
 
-static void lock_descriptor(char *filename, char *image, int size)
+static void lock_descriptor(char *image, int size)
 {
 	int wr_shift, rd_shift;
 	fdbar_t *fdb = find_fd(image, size);
@@ -860,11 +884,9 @@ static void lock_descriptor(char *filename, char *image, int size)
 		fmba->flmstr3 |= 0x8 << wr_shift;
 		break;
 	}
-
-	write_image(filename, image, size);
 }
 
-static void unlock_descriptor(char *filename, char *image, int size)
+static void unlock_descriptor(char *image, int size)
 {
 	fdbar_t *fdb = find_fd(image, size);
 	fmba_t *fmba = (fmba_t *) (image + (((fdb->flmap1) & 0xff) << 4));
@@ -880,8 +902,6 @@ static void unlock_descriptor(char *filename, char *image, int size)
 		/* Keep chipset specific Requester ID */
 		fmba->flmstr3 = 0x08080000 | (fmba->flmstr3 & 0xffff);
 	}
-
-	write_image(filename, image, size);
 }
 
 void inject_region(char *filename, char *image, int size, int region_type,
@@ -949,7 +969,6 @@ void inject_region(char *filename, char *image, int size, int region_type,
 
 	printf("Adding %s as the %s section of %s\n",
 	       region_fname, region_name(region_type), filename);
-	write_image(filename, image, size);
 }
 
 unsigned int next_pow2(unsigned int x)
@@ -1147,6 +1166,7 @@ static void print_usage(const char *name)
 	       "   -f | --layout <filename>           dump regions into a flashrom layout file\n"
 	       "   -x | --extract:                    extract intel fd modules\n"
 	       "   -i | --inject <region>:<module>    inject file <module> into region <region>\n"
+	       "                                      can be given once for each region\n"
 	       "   -n | --newlayout <filename>        update regions using a flashrom layout file\n"
 	       "   -s | --spifreq <17|20|30|33|48|50> set the SPI frequency\n"
 	       "   -D | --density <512|1|2|4|8|16>    set chip density (512 in KByte, others in MByte)\n"
@@ -1159,9 +1179,15 @@ static void print_usage(const char *name)
 	       "   -u | --unlock                      Unlock firmware descriptor and ME region\n"
 	       "   -p | --platform                    Add platform-specific quirks\n"
 	       "                                      aplk - Apollo Lake\n"
+	       "   -O | --output <filename>           write the new image to <filename>\n"
+	       "                                      instead of <filename>.new, which\n"
+	       "                                      may be the input file itself\n"
 	       "   -v | --version:                    print the version\n"
 	       "   -h | --help:                       print this help\n\n"
 	       "<region> is one of Descriptor, BIOS, ME, GbE, Platform\n"
+	       "\n"
+	       "--inject, --spifreq, --density, --em100, --lock and --unlock can be\n"
+	       "combined, the new image is written once after applying all of them.\n"
 	       "\n");
 }
 
@@ -1172,7 +1198,8 @@ int main(int argc, char *argv[])
 	int mode_em100 = 0, mode_locked = 0, mode_unlocked = 0;
 	int mode_layout = 0, mode_newlayout = 0, mode_density = 0;
 	char *region_type_string = NULL, *region_fname = NULL, *layout_fname = NULL;
-	int region_type = -1, inputfreq = 0;
+	char *inject_fnames[MAX_REGIONS] = { NULL };
+	int region_type, inputfreq = 0, i;
 	unsigned int new_density = 0;
 	enum spi_frequency spifreq = SPI_FREQUENCY_20MHZ;
 
@@ -1191,10 +1218,11 @@ int main(int argc, char *argv[])
 		{"version", 0, NULL, 'v'},
 		{"help", 0, NULL, 'h'},
 		{"platform", 0, NULL, 'p'},
+		{"output", 1, NULL, 'O'},
 		{0, 0, 0, 0}
 	};
 
-	while ((opt = getopt_long(argc, argv, "df:D:C:xi:n:s:p:eluvh?",
+	while ((opt = getopt_long(argc, argv, "df:D:C:xi:n:s:p:O:eluvh?",
 				  long_options, &option_index)) != EOF) {
 		switch (opt) {
 		case 'd':
@@ -1224,6 +1252,7 @@ int main(int argc, char *argv[])
 			region_fname++;
 			// Descriptor, BIOS, ME, GbE, Platform
 			// valid type?
+			region_type = -1;
 			if (!strcasecmp("Descriptor", region_type_string))
 				region_type = 0;
 			else if (!strcasecmp("BIOS", region_type_string))
@@ -1242,6 +1271,13 @@ int main(int argc, char *argv[])
 				print_usage(argv[0]);
 				exit(EXIT_FAILURE);
 			}
+			if (inject_fnames[region_type]) {
+				fprintf(stderr, "Region %s injected twice\n\n",
+					region_type_string);
+				print_usage(argv[0]);
+				exit(EXIT_FAILURE);
+			}
+			inject_fnames[region_type] = region_fname;
 			mode_inject = 1;
 			break;
 		case 'n':
@@ -1353,6 +1389,9 @@ int main(int argc, char *argv[])
 				exit(EXIT_FAILURE);
 			}
 			break;
+		case 'O':
+			output_fname = optarg;
+			break;
 		case 'v':
 			print_version();
 			exit(EXIT_SUCCESS);
@@ -1366,9 +1405,9 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	if ((mode_dump + mode_layout + mode_extract + mode_inject +
-		mode_newlayout + (mode_spifreq | mode_em100 | mode_unlocked |
-		 mode_locked)) > 1) {
+	if ((mode_dump + mode_layout + mode_extract + mode_newlayout +
+	     (mode_inject | mode_spifreq | mode_density | mode_em100 |
+	      mode_unlocked | mode_locked)) > 1) {
 		fprintf(stderr, "You may not specify more than one mode.\n\n");
 		print_usage(argv[0]);
 		exit(EXIT_FAILURE);
@@ -1427,27 +1466,33 @@ int main(int argc, char *argv[])
 	if (mode_extract)
 		write_regions(image, size);
 
-	if (mode_inject)
-		inject_region(filename, image, size, region_type,
-				region_fname);
-
 	if (mode_newlayout)
 		new_layout(filename, image, size, layout_fname);
 
+	for (i = 0; i < MAX_REGIONS; i++) {
+		if (inject_fnames[i])
+			inject_region(filename, image, size, i,
+				      inject_fnames[i]);
+	}
+
 	if (mode_spifreq)
-		set_spi_frequency(filename, image, size, spifreq);
+		set_spi_frequency(image, size, spifreq);
 
 	if (mode_density)
-		set_chipdensity(filename, image, size, new_density);
+		set_chipdensity(image, size, new_density);
 
 	if (mode_em100)
-		set_em100_mode(filename, image, size);
+		set_em100_mode(image, size);
 
 	if (mode_locked)
-		lock_descriptor(filename, image, size);
+		lock_descriptor(image, size);
 
 	if (mode_unlocked)
-		unlock_descriptor(filename, image, size);
+		unlock_descriptor(image, size);
+
+	if (mode_inject || mode_spifreq || mode_density || mode_em100 ||
+	    mode_locked || mode_unlocked)
+		write_image(filename, image, size);
 
 	free(image);
 
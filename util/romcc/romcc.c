@@ -18194,6 +18194,7 @@ struct live_range_def {
 	unsigned orig_id;
 };
 
+/* Initial size of the interference graph hash, it doubles as edges are added */
 #define LRE_HASH_SIZE 2048
 struct lre_hash {
 	struct lre_hash *next;
@@ -18203,7 +18204,9 @@ struct lre_hash {
 
 
 struct reg_state {
-	struct lre_hash *hash[LRE_HASH_SIZE];
+	struct lre_hash **hash;
+	unsigned hash_size;
+	unsigned hash_count;
 	struct reg_block *blocks;
 	struct live_range_def *lrd;
 	struct live_range *lr;
@@ -18412,26 +18415,15 @@ static void reg_inc_used(struct compile_state *state, char *used, int reg)
 	return;
 }
 
-static unsigned int hash_live_edge(
+static unsigned int hash_live_edge(struct reg_state *rstate,
 	struct live_range *left, struct live_range *right)
 {
-	unsigned int hash, val;
-	unsigned long lval, rval;
+	unsigned long hash, lval, rval;
 	lval = ((unsigned long)left)/sizeof(struct live_range);
 	rval = ((unsigned long)right)/sizeof(struct live_range);
-	hash = 0;
-	while(lval) {
-		val = lval & 0xff;
-		lval >>= 8;
-		hash = (hash *263) + val;
-	}
-	while(rval) {
-		val = rval & 0xff;
-		rval >>= 8;
-		hash = (hash *263) + val;
-	}
-	hash = hash & (LRE_HASH_SIZE - 1);
-	return hash;
+	hash = (lval * 0x9e3779b1UL) ^ rval;
+	hash ^= hash >> 16;
+	return hash & (rstate->hash_size - 1);
 }
 
 static struct lre_hash **lre_probe(struct reg_state *rstate,
@@ -18439,6 +18431,9 @@ static struct lre_hash **lre_probe(struct reg_state *rstate,
 {
 	struct lre_hash **ptr;
 	unsigned int index;
+	if (!rstate->hash) {
+		return 0;
+	}
 	/* Ensure left <= right */
 	if (left > right) {
 		struct live_range *tmp;
@@ -18446,7 +18441,7 @@ static struct lre_hash **lre_probe(struct reg_state *rstate,
 		left = right;
 		right = tmp;
 	}
-	index = hash_live_edge(left, right);
+	index = hash_live_edge(rstate, left, right);
 
 	ptr = &rstate->hash[index];
 	while(*ptr) {
@@ -18458,6 +18453,30 @@ static struct lre_hash **lre_probe(struct reg_state *rstate,
 	return ptr;
 }
 
+/* Keep the hash chains short, the interference graph of a big
+ * function has millions of edges.
+ */
+static void grow_lre_hash(struct reg_state *rstate)
+{
+	struct lre_hash **old_hash, *entry, *next;
+	unsigned old_size, i, index;
+
+	old_hash = rstate->hash;
+	old_size = rstate->hash_size;
+	rstate->hash_size = old_size ? old_size * 2 : LRE_HASH_SIZE;
+	rstate->hash = xcmalloc(sizeof(*rstate->hash) * rstate->hash_size,
+		"lre_hash table");
+	for(i = 0; i < old_size; i++) {
+		for(entry = old_hash[i]; entry; entry = next) {
+			next = entry->next;
+			index = hash_live_edge(rstate, entry->left, entry->right);
+			entry->next = rstate->hash[index];
+			rstate->hash[index] = entry;
+		}
+	}
+	xfree(old_hash);
+}
+
 static int interfere(struct reg_state *rstate,
 	struct live_range *left, struct live_range *right)
 {
@@ -18486,6 +18505,9 @@ static void add_live_edge(struct reg_state *rstate,
 		left = right;
 		right = tmp;
 	}
+	if (rstate->hash_count >= rstate->hash_size) {
+		grow_lre_hash(rstate);
+	}
 	ptr = lre_probe(rstate, left, right);
 	if (*ptr) {
 		return;
@@ -18499,6 +18521,7 @@ static void add_live_edge(struct reg_state *rstate,
 	new_hash->left  = left;
 	new_hash->right = right;
 	*ptr = new_hash;
+	rstate->hash_count += 1;
 
 	edge = xmalloc(sizeof(*edge), "live_range_edge");
 	edge->next   = left->edges;
@@ -18525,6 +18548,7 @@ static void remove_live_edge(struct reg_state *rstate,
 	entry = *hptr;
 	*hptr = entry->next;
 	xfree(entry);
+	rstate->hash_count -= 1;
 
 	for(ptr = &left->edges; *ptr; ptr = &(*ptr)->next) {
 		edge = *ptr;
@@ -18548,15 +18572,6 @@ static void remove_live_edge(struct reg_state *rstate,
 	}
 }
 
-static void remove_live_edges(struct reg_state *rstate, struct live_range *range)
-{
-	struct live_range_edge *edge, *next;
-	for(edge = range->edges; edge; edge = next) {
-		next = edge->next;
-		remove_live_edge(rstate, range, edge->node);
-	}
-}
-
 static void transfer_live_edges(struct reg_state *rstate,
 	struct live_range *dest, struct live_range *src)
 {
@@ -20034,11 +20049,28 @@ static void ids_from_rstate(struct compile_state *state,
 
 static void cleanup_live_edges(struct reg_state *rstate)
 {
-	int i;
-	/* Free the edges on each node */
+	struct live_range_edge *edge, *next;
+	struct lre_hash *entry, *next_entry;
+	unsigned i;
+	/* Free the edges on each node.  All of them go away, so there
+	 * is no need to unlink them one by one with remove_live_edge.
+	 */
 	for(i = 1; i <= rstate->ranges; i++) {
-		remove_live_edges(rstate, &rstate->lr[i]);
+		for(edge = rstate->lr[i].edges; edge; edge = next) {
+			next = edge->next;
+			xfree(edge);
+			rstate->lr[i].degree -= 1;
+		}
+		rstate->lr[i].edges = 0;
+	}
+	for(i = 0; i < rstate->hash_size; i++) {
+		for(entry = rstate->hash[i]; entry; entry = next_entry) {
+			next_entry = entry->next;
+			xfree(entry);
+		}
+		rstate->hash[i] = 0;
 	}
+	rstate->hash_count = 0;
 }
 
 static void cleanup_rstate(struct compile_state *state, struct reg_state *rstate)
@@ -20215,6 +20247,7 @@ static void allocate_registers(struct compile_state *state)
 
 	/* Cleanup the temporary data structures */
 	cleanup_rstate(state, &rstate);
+	xfree(rstate.hash);
 
 	/* Display the new graph */
 	print_blocks(state, __func__, state->dbgout);
@@ -38,6 +38,7 @@ XFAIL_TESTS="
 BASEDIR="$(dirname "$0")"
 BUILDDIR="$BASEDIR/build"
 LOGDIR="$BUILDDIR/logs"
+TIMES="$BUILDDIR/times.txt"
 mkdir -p "$BUILDDIR"
 mkdir -p "$LOGDIR"
 
@@ -78,6 +79,19 @@ init_stats() {
 	NUM_FIXED=0	# Number of tests that passed unexpectedly
 }
 
+# Seconds since the epoch, with fractions where date supports %N.
+timestamp() {
+	date +%s.%N | sed 's/\.N$//'
+}
+
+# Record how long a test took since the timestamp in $2, and show it.
+record_time() {
+	local seconds="$(echo "$(timestamp) $2" | awk '{ printf "%.2f", $1 - $2 }')"
+
+	printf "%s\t%s\n" "$(basename "$1")" "$seconds" >> "$TIMES"
+	printf " in %ss" "$seconds"
+}
+
 get_romcc() {
 	ROMCC="$BUILDDIR/romcc"
 	if [ ! -f "$ROMCC" ]; then
@@ -89,12 +103,14 @@ get_romcc() {
 init_testing() {
 	init_stats
 	get_romcc
+	: > "$TIMES"
 }
 
 show_stats() {
 	printf "passed: %s\t(%s newly fixed)\n" $NUM_PASS $NUM_FIXED
 	printf "failed: %s\t(%s known broken)\n" $NUM_FAIL $NUM_BROKEN
 	printf "total:  %s\n" $NUM_TOTAL
+	printf "time per test in %s\n" "$TIMES"
 }
 
 is_xfail() {
@@ -116,6 +132,7 @@ pass() {
 		blue " (fixed)"
 		NUM_FIXED=$((NUM_FIXED + 1))
 	fi
+	record_time "$1" "$2"
 	echo
 }
 
@@ -128,6 +145,7 @@ fail() {
 		blue " (known broken)"
 		NUM_BROKEN=$((NUM_BROKEN + 1))
 	fi
+	record_time "$1" "$2"
 	echo
 }
 
@@ -143,6 +161,7 @@ run_simple_tests() {
 	for t in $(find "$BASEDIR/tests" -name 'simple_test*.c'); do
 		printf "%s" "$(basename "$t")"
 
+		local start="$(timestamp)"
 		local result=pass
 		local logfile="$LOGDIR/$(basename "$t").log"
 		rm "$logfile" >/dev/null 2>&1
@@ -158,7 +177,7 @@ run_simple_tests() {
 			fi
 		done
 		printf " "
-		$result "$t"
+		$result "$t" "$start"
 	done
 
 	echo
@@ -186,10 +205,11 @@ run_linux_tests() {
 		printf "%s... " "$(basename "$t")"
 
 		local logfile="$LOGDIR/$(basename "$t").log"
+		local start="$(timestamp)"
 		if run_linux_test "$t" > "$logfile" 2>&1; then
-			pass "$t"
+			pass "$t" "$start"
 		else
-			fail "$t"
+			fail "$t" "$start"
 		fi
 	done
 